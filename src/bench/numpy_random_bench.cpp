@@ -0,0 +1,418 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "numpy_random.h"
+#include "numpy_random_counter.h"
+
+extern "C" {
+#include "numpy/random/bitgen.h"
+#include "numpy/random/distributions.h"
+#include "numpy/random/legacy/legacy-distributions.h"
+}
+
+/*
+Every benchmark reports `time/sample` (wall time per produced value) and `bytes/sample` (engine output
+consumed per value). Scalar RandomState methods measure the locked single draw path, `kernel/`
+entries call the C kernels directly through with_bitgen and `fill/` entries the bulk paths.
+*/
+
+namespace {
+constexpr size_t kBatch = 4096;
+
+/* 128 bit LCG returning a custom arithmetic type, exercises RandomState's custom arithmetic path. */
+struct uint128 {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    uint128() = default;
+    uint128(uint64_t value) : lo(value) {}
+    uint128(uint64_t high, uint64_t low) : hi(high), lo(low) {}
+
+    uint128 operator>>(const uint128& shift) const {
+        unsigned int n = (unsigned int)shift.lo;
+        if (n == 0) {
+            return *this;
+        }
+        if (n >= 64) {
+            return uint128(0, hi >> (n - 64));
+        }
+        return uint128(hi >> n, (lo >> n) | (hi << (64 - n)));
+    }
+
+    uint128& operator>>=(int shift) {
+        *this = *this >> uint128((uint64_t)shift);
+        return *this;
+    }
+
+    uint128 operator&(const uint128& other) const {
+        return uint128(hi & other.hi, lo & other.lo);
+    }
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T>, bool> = true>
+    explicit operator T() const {
+        return (T)lo;
+    }
+};
+
+class lcg128_engine {
+public:
+    uint128 operator()() {
+        /* state = state * 0x2360ed051fc65da44385df649fccf645 + 0x5851f42d4c957f2d14057b7ef767814f */
+        const uint64_t mul_hi = 0x2360ed051fc65da4ULL, mul_lo = 0x4385df649fccf645ULL;
+        const uint64_t inc_hi = 0x5851f42d4c957f2dULL, inc_lo = 0x14057b7ef767814fULL;
+        uint64_t hi = 0;
+        uint64_t lo = numpy_random_internel::mulhilo64(_state.lo, mul_lo, &hi);
+        hi += _state.lo * mul_hi + _state.hi * mul_lo;
+        lo += inc_lo;
+        hi += inc_hi + (lo < inc_lo);
+        _state = uint128(hi, lo);
+        /* The raw LCG low bits have short periods, scramble both halves before handing them out. */
+        return uint128(mix64(hi), mix64(hi ^ lo));
+    }
+
+    void seed(uint64_t seed) {
+        _state = uint128(seed, ~seed);
+    }
+
+private:
+    static uint64_t mix64(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    uint128 _state{0x853c49e6748fea9bULL, 0xda3e39cb94b95bdbULL};
+};
+
+/* Wraps an engine to count the bytes RandomState pulls from it. */
+template <typename Engine>
+class counted_engine : public Engine {
+public:
+    auto operator()() {
+        auto out = Engine::operator()();
+        bytes += output_bytes();
+        return out;
+    }
+
+    uint64_t bytes = 0;
+
+private:
+    /* Arithmetic outputs are as wide as max(), like RandomState::narrow_engine decides, since
+    std::mt19937 returns its 32 bit values in an 8 byte uint_fast32_t. */
+    static constexpr uint64_t output_bytes() {
+        using result_type = decltype(std::declval<Engine&>()());
+        if constexpr (std::is_arithmetic_v<result_type> &&
+                      sizeof(result_type) <= sizeof(uint64_t)) {
+            uint64_t bits = 0;
+            for (uint64_t max = (uint64_t)(Engine::max)(); max != 0; max >>= 1) {
+                bits++;
+            }
+            return (bits + 7) / 8;
+        }
+        else {
+            return sizeof(result_type);
+        }
+    }
+};
+
+template <typename Engine>
+void set_counters(benchmark::State& st, RandomState<counted_engine<Engine>>& random,
+                  size_t per_iteration) {
+    double samples = (double)st.iterations() * (double)per_iteration;
+    st.SetItemsProcessed((int64_t)samples);
+    /* kIsRate | kInvert reports elapsed seconds / samples, printed with an SI prefix (eg. 12ns). */
+    st.counters["time/sample"] =
+        benchmark::Counter(samples, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    st.counters["bytes/sample"] = (double)random.get_engine().bytes / samples;
+}
+
+/* Scalar RandomState methods, one lock per draw. */
+template <typename Engine, typename Draw>
+void bench_method(benchmark::State& st, Draw draw) {
+    RandomState<counted_engine<Engine>> random;
+    random.get_engine().seed(12345);
+    for (auto _ : st) {
+        for (size_t i = 0; i < kBatch; i++) {
+            benchmark::DoNotOptimize(draw(random));
+        }
+    }
+    set_counters<Engine>(st, random, kBatch);
+}
+
+/* Bulk RandomState methods, one lock per kBatch values. */
+template <typename Engine, typename T, typename Fill>
+void bench_fill(benchmark::State& st, Fill fill) {
+    RandomState<counted_engine<Engine>> random;
+    random.get_engine().seed(12345);
+    std::vector<T> out(kBatch);
+    for (auto _ : st) {
+        fill(random, out.data(), out.size());
+        benchmark::ClobberMemory();
+    }
+    set_counters<Engine>(st, random, kBatch);
+}
+
+/* C kernels called directly, no lock per draw. */
+template <typename Engine, typename Kernel>
+void bench_kernel(benchmark::State& st, Kernel kernel) {
+    RandomState<counted_engine<Engine>> random;
+    random.get_engine().seed(12345);
+    random.with_bitgen([&](bitgen_t* bitgen_state, aug_bitgen_t* aug_state, binomial_t* binomial) {
+        for (auto _ : st) {
+            for (size_t i = 0; i < kBatch; i++) {
+                benchmark::DoNotOptimize(kernel(bitgen_state, aug_state, binomial));
+            }
+        }
+    });
+    set_counters<Engine>(st, random, kBatch);
+}
+
+/* C fill kernels, **per_call** values per call. */
+template <typename Engine, typename Kernel>
+void bench_kernel_fill(benchmark::State& st, size_t per_call, Kernel kernel) {
+    RandomState<counted_engine<Engine>> random;
+    random.get_engine().seed(12345);
+    random.with_bitgen([&](bitgen_t* bitgen_state, aug_bitgen_t* aug_state, binomial_t* binomial) {
+        for (auto _ : st) {
+            kernel(bitgen_state, aug_state, binomial);
+            benchmark::ClobberMemory();
+        }
+    });
+    set_counters<Engine>(st, random, per_call);
+}
+
+template <typename Engine, typename Draw>
+void add_method(const std::string& engine, const char* name, Draw draw) {
+    benchmark::RegisterBenchmark(("method/" + std::string(name) + "/" + engine).c_str(),
+                                 [draw](benchmark::State& st) { bench_method<Engine>(st, draw); });
+}
+
+template <typename Engine, typename T, typename Fill>
+void add_fill(const std::string& engine, const char* name, Fill fill) {
+    benchmark::RegisterBenchmark(("fill/" + std::string(name) + "/" + engine).c_str(),
+                                 [fill](benchmark::State& st) { bench_fill<Engine, T>(st, fill); });
+}
+
+template <typename Engine, typename Kernel>
+void add_kernel(const std::string& engine, const char* name, Kernel kernel) {
+    benchmark::RegisterBenchmark(
+        ("kernel/" + std::string(name) + "/" + engine).c_str(),
+        [kernel](benchmark::State& st) { bench_kernel<Engine>(st, kernel); });
+}
+
+template <typename Engine, typename Kernel>
+void add_kernel_fill(const std::string& engine, const char* name, size_t per_call,
+                     Kernel kernel) {
+    benchmark::RegisterBenchmark(
+        ("kernel_fill/" + std::string(name) + "/" + engine).c_str(),
+        [per_call, kernel](benchmark::State& st) { bench_kernel_fill<Engine>(st, per_call, kernel); });
+}
+
+/* Shorthand for the kernel table below. */
+#define KERNEL(name, expr)                                                                      \
+    add_kernel<Engine>(engine, name,                                                            \
+                       [](bitgen_t* bitgen_state, aug_bitgen_t* aug_state, binomial_t* binomial) { \
+                           (void)bitgen_state;                                                  \
+                           (void)aug_state;                                                     \
+                           (void)binomial;                                                      \
+                           return (expr);                                                       \
+                       })
+
+#define KERNEL_FILL(name, type, call)                                                           \
+    add_kernel_fill<Engine>(                                                                    \
+        engine, name, kBatch,                                                                   \
+        [out = std::make_shared<std::vector<type>>(kBatch)](                                    \
+            bitgen_t* bitgen_state, aug_bitgen_t* aug_state, binomial_t* binomial) {            \
+            (void)aug_state;                                                                    \
+            (void)binomial;                                                                     \
+            type* data = out->data();                                                           \
+            call;                                                                               \
+        })
+
+template <typename Engine>
+void register_engine(const std::string& engine) {
+    add_method<Engine>(engine, "beta(0.5,0.5)", [](auto& r) { return r.beta(0.5, 0.5); });
+    add_method<Engine>(engine, "beta(2,3)", [](auto& r) { return r.beta(2.0, 3.0); });
+    add_method<Engine>(engine, "binomial(10,0.3)", [](auto& r) { return r.binomial(10, 0.3); });
+    add_method<Engine>(engine, "binomial(1000,0.3)", [](auto& r) { return r.binomial(1000, 0.3); });
+    add_method<Engine>(engine, "gamma(3,2)", [](auto& r) { return r.gamma(3.0, 2.0); });
+    add_method<Engine>(engine, "uniform(0,1)", [](auto& r) { return r.uniform(0.0, 1.0); });
+    add_method<Engine>(engine, "rand_int(0,9)", [](auto& r) { return r.rand_int(0, 9); });
+    add_method<Engine>(engine, "rand_int<int64>(0,1e12)",
+                       [](auto& r) { return r.rand_int((int64_t)0, (int64_t)1000000000000); });
+    add_method<Engine>(engine, "rand_n", [](auto& r) { return r.template rand_n<double>(); });
+
+    add_fill<Engine, double>(engine, "standard_uniform_fill",
+                             [](auto& r, double* out, size_t n) { r.standard_uniform_fill(out, n); });
+    add_fill<Engine, double>(engine, "standard_normal_fill",
+                             [](auto& r, double* out, size_t n) { r.standard_normal_fill(out, n); });
+    add_fill<Engine, double>(engine, "standard_exponential_fill", [](auto& r, double* out,
+                                                                     size_t n) {
+        r.standard_exponential_fill(out, n);
+    });
+    add_fill<Engine, double>(engine, "exponential_fill(2)",
+                             [](auto& r, double* out, size_t n) { r.exponential_fill(2.0, out, n); });
+    add_fill<Engine, uint64_t>(engine, "uint64_fill",
+                               [](auto& r, uint64_t* out, size_t n) { r.uint64_fill(out, n); });
+    add_fill<Engine, uint8_t>(engine, "bernoulli_fill(0.3)",
+                              [](auto& r, uint8_t* out, size_t n) { r.bernoulli_fill(0.3, out, n); });
+    add_fill<Engine, uint8_t>(engine, "bernoulli_fill_packed(0.3)", [](auto& r, uint8_t* out,
+                                                                       size_t n) {
+        r.bernoulli_fill_packed(0.3, reinterpret_cast<uint64_t*>(out), n / 8 * 8);
+    });
+
+    KERNEL("random_standard_uniform", random_standard_uniform(bitgen_state));
+    KERNEL("random_standard_uniform_f", random_standard_uniform_f(bitgen_state));
+    KERNEL("random_standard_exponential", random_standard_exponential(bitgen_state));
+    KERNEL("random_standard_exponential_f", random_standard_exponential_f(bitgen_state));
+    KERNEL("random_standard_normal", random_standard_normal(bitgen_state));
+    KERNEL("random_standard_normal_f", random_standard_normal_f(bitgen_state));
+    KERNEL("random_standard_gamma(0.5)", random_standard_gamma(bitgen_state, 0.5));
+    KERNEL("random_standard_gamma(3)", random_standard_gamma(bitgen_state, 3.0));
+    KERNEL("random_standard_gamma_f(3)", random_standard_gamma_f(bitgen_state, 3.0f));
+    KERNEL("random_positive_int64", random_positive_int64(bitgen_state));
+    KERNEL("random_positive_int32", random_positive_int32(bitgen_state));
+    KERNEL("random_uint", random_uint(bitgen_state));
+    KERNEL("random_normal", random_normal(bitgen_state, 1.0, 2.0));
+    KERNEL("random_exponential", random_exponential(bitgen_state, 2.0));
+    KERNEL("random_uniform", random_uniform(bitgen_state, -1.0, 2.0));
+    KERNEL("random_gamma(3,2)", random_gamma(bitgen_state, 3.0, 2.0));
+    KERNEL("random_beta(0.5,0.5)", random_beta(bitgen_state, 0.5, 0.5));
+    KERNEL("random_beta(2,3)", random_beta(bitgen_state, 2.0, 3.0));
+    KERNEL("random_chisquare(3)", random_chisquare(bitgen_state, 3.0));
+    KERNEL("random_f(3,5)", random_f(bitgen_state, 3.0, 5.0));
+    KERNEL("random_standard_cauchy", random_standard_cauchy(bitgen_state));
+    KERNEL("random_pareto(3)", random_pareto(bitgen_state, 3.0));
+    KERNEL("random_weibull(3)", random_weibull(bitgen_state, 3.0));
+    KERNEL("random_power(3)", random_power(bitgen_state, 3.0));
+    KERNEL("random_laplace", random_laplace(bitgen_state, 0.0, 1.0));
+    KERNEL("random_gumbel", random_gumbel(bitgen_state, 0.0, 1.0));
+    KERNEL("random_logistic", random_logistic(bitgen_state, 0.0, 1.0));
+    KERNEL("random_lognormal", random_lognormal(bitgen_state, 0.0, 1.0));
+    KERNEL("random_rayleigh", random_rayleigh(bitgen_state, 1.0));
+    KERNEL("random_standard_t(5)", random_standard_t(bitgen_state, 5.0));
+    KERNEL("random_noncentral_chisquare(3,2)",
+           random_noncentral_chisquare(bitgen_state, 3.0, 2.0));
+    KERNEL("random_noncentral_f(3,5,2)", random_noncentral_f(bitgen_state, 3.0, 5.0, 2.0));
+    KERNEL("random_wald(1,2)", random_wald(bitgen_state, 1.0, 2.0));
+    KERNEL("random_vonmises(0,4)", random_vonmises(bitgen_state, 0.0, 4.0));
+    KERNEL("random_triangular(0,1,3)", random_triangular(bitgen_state, 0.0, 1.0, 3.0));
+    KERNEL("random_poisson(3)", random_poisson(bitgen_state, 3.0));
+    KERNEL("random_poisson(100)", random_poisson(bitgen_state, 100.0));
+    KERNEL("random_negative_binomial(5,0.3)", random_negative_binomial(bitgen_state, 5.0, 0.3));
+    KERNEL("random_binomial(10,0.3)", random_binomial(bitgen_state, 0.3, 10, binomial));
+    KERNEL("random_binomial(1000,0.3)", random_binomial(bitgen_state, 0.3, 1000, binomial));
+    KERNEL("random_logseries(0.9)", random_logseries(bitgen_state, 0.9));
+    KERNEL("random_geometric(0.3)", random_geometric(bitgen_state, 0.3));
+    KERNEL("random_geometric(0.01)", random_geometric(bitgen_state, 0.01));
+    KERNEL("random_zipf(1.5)", random_zipf(bitgen_state, 1.5));
+    KERNEL("random_zipf(3)", random_zipf(bitgen_state, 3.0));
+    KERNEL("random_hypergeometric(50,50,20)", random_hypergeometric(bitgen_state, 50, 50, 20));
+    KERNEL("random_hypergeometric(500,500,200)",
+           random_hypergeometric(bitgen_state, 500, 500, 200));
+    KERNEL("random_interval(1000)", random_interval(bitgen_state, 1000));
+    KERNEL("random_bounded_uint64(masked)",
+           random_bounded_uint64(bitgen_state, 0, 999999999999ULL, 0xffffffffffULL, true));
+    KERNEL("random_bounded_uint64(lemire)",
+           random_bounded_uint64(bitgen_state, 0, 999999999999ULL, 0, false));
+
+    KERNEL("legacy_gauss", legacy_gauss(aug_state));
+    KERNEL("legacy_standard_exponential", legacy_standard_exponential(aug_state));
+    KERNEL("legacy_standard_gamma(0.5)", legacy_standard_gamma(aug_state, 0.5));
+    KERNEL("legacy_standard_gamma(3)", legacy_standard_gamma(aug_state, 3.0));
+    KERNEL("legacy_beta(0.5,0.5)", legacy_beta(aug_state, 0.5, 0.5));
+    KERNEL("legacy_beta(2,3)", legacy_beta(aug_state, 2.0, 3.0));
+    KERNEL("legacy_random_binomial(10,0.3)", legacy_random_binomial(bitgen_state, 0.3, 10, binomial));
+    KERNEL("legacy_random_binomial(1000,0.3)",
+           legacy_random_binomial(bitgen_state, 0.3, 1000, binomial));
+
+    /* Static so the capture-free fill lambdas can refer to it. */
+    static const gamma_t gamma3 = [] {
+        gamma_t gamma{};
+        random_gamma_prepare(&gamma, 3.0);
+        return gamma;
+    }();
+
+    KERNEL_FILL("random_standard_uniform_fill", double,
+                random_standard_uniform_fill(bitgen_state, kBatch, data));
+    KERNEL_FILL("random_standard_uniform_fill_f", float,
+                random_standard_uniform_fill_f(bitgen_state, kBatch, data));
+    KERNEL_FILL("random_standard_exponential_fill", double,
+                random_standard_exponential_fill(bitgen_state, kBatch, data));
+    KERNEL_FILL("random_standard_exponential_fill_f", float,
+                random_standard_exponential_fill_f(bitgen_state, kBatch, data));
+    KERNEL_FILL("random_standard_exponential_inv_fill", double,
+                random_standard_exponential_inv_fill(bitgen_state, kBatch, data));
+    KERNEL_FILL("random_standard_exponential_inv_fill_f", float,
+                random_standard_exponential_inv_fill_f(bitgen_state, kBatch, data));
+    KERNEL_FILL("legacy_standard_exponential_fill", double,
+                legacy_standard_exponential_fill(aug_state, kBatch, data));
+    KERNEL_FILL("random_standard_gamma_fill(3)", double,
+                random_standard_gamma_fill(bitgen_state, &gamma3, kBatch, data));
+    KERNEL_FILL("legacy_standard_gamma_fill(3)", double,
+                legacy_standard_gamma_fill(aug_state, &gamma3, kBatch, data));
+    KERNEL_FILL("random_standard_normal_fill", double,
+                random_standard_normal_fill(bitgen_state, kBatch, data));
+    KERNEL_FILL("random_standard_normal_fill_f", float,
+                random_standard_normal_fill_f(bitgen_state, kBatch, data));
+    KERNEL_FILL("random_bounded_uint64_fill(lemire)", uint64_t,
+                random_bounded_uint64_fill(bitgen_state, 0, 999999999999ULL, kBatch, false, data));
+    KERNEL_FILL("random_bounded_uint32_fill(masked)", uint32_t,
+                random_bounded_uint32_fill(bitgen_state, 0, 999999, kBatch, true, data));
+    KERNEL_FILL("random_bounded_uint32_fill(lemire)", uint32_t,
+                random_bounded_uint32_fill(bitgen_state, 0, 999999, kBatch, false, data));
+    KERNEL_FILL("random_bounded_uint16_fill(lemire)", uint16_t,
+                random_bounded_uint16_fill(bitgen_state, 0, 999, kBatch, false, data));
+    KERNEL_FILL("random_bounded_uint8_fill(lemire)", uint8_t,
+                random_bounded_uint8_fill(bitgen_state, 0, 99, kBatch, false, data));
+    KERNEL_FILL("random_bounded_bool_fill", npy_bool,
+                random_bounded_bool_fill(bitgen_state, 0, 1, kBatch, true, data));
+    KERNEL_FILL("random_bernoulli_fill(0.3)", npy_bool,
+                random_bernoulli_fill(bitgen_state, 0.3, kBatch, data));
+    KERNEL_FILL("random_bernoulli_fill_packed(0.3)", uint64_t,
+                random_bernoulli_fill_packed(bitgen_state, 0.3, kBatch, data));
+    add_kernel_fill<Engine>(engine, "random_multinomial(1000,4)", 1,
+                            [](bitgen_t* bitgen_state, aug_bitgen_t*, binomial_t* binomial) {
+                                RAND_INT_TYPE counts[4] = {0, 0, 0, 0};
+                                double pvals[4] = {0.1, 0.2, 0.3, 0.4};
+                                random_multinomial(bitgen_state, 1000, counts, pvals, 4, binomial);
+                                benchmark::DoNotOptimize(counts);
+                            });
+    add_kernel_fill<Engine>(engine, "random_multivariate_hypergeometric_count", 1,
+                            [](bitgen_t* bitgen_state, aug_bitgen_t*, binomial_t*) {
+                                int64_t colors[3] = {20, 30, 50};
+                                int64_t variates[3];
+                                random_multivariate_hypergeometric_count(bitgen_state, 100, 3,
+                                                                         colors, 40, 1, variates);
+                                benchmark::DoNotOptimize(variates);
+                            });
+    add_kernel_fill<Engine>(engine, "random_multivariate_hypergeometric_marginals", 1,
+                            [](bitgen_t* bitgen_state, aug_bitgen_t*, binomial_t*) {
+                                int64_t colors[3] = {20, 30, 50};
+                                int64_t variates[3];
+                                random_multivariate_hypergeometric_marginals(
+                                    bitgen_state, 100, 3, colors, 40, 1, variates);
+                                benchmark::DoNotOptimize(variates);
+                            });
+}
+
+#undef KERNEL
+#undef KERNEL_FILL
+} // namespace
+
+int main(int argc, char** argv) {
+    register_engine<std::mt19937>("mt19937");
+    register_engine<std::mt19937_64>("mt19937_64");
+    register_engine<Philox4x64>("philox4x64");
+    register_engine<lcg128_engine>("lcg128");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -1,6 +1,9 @@
 #ifndef NUMPY_CORE_INCLUDE_NUMPY_NPY_COMMON_H_
 #define NUMPY_CORE_INCLUDE_NUMPY_NPY_COMMON_H_
 
+#include <stdint.h>
+#include <stdlib.h>
+
 /* numpconfig.h is auto-generated */
 #include "numpyconfig.h"
 
@@ -14,7 +14,16 @@ typedef struct bitgen {
   uint32_t (*next_uint32)(void *st);
   double (*next_double)(void *st);
   uint64_t (*next_raw)(void *st);
+#ifdef NUMPY_RANDOM_STATS
+  uint64_t rejection_trials; /* iterations of the rejection loops, accepted ones included */
+#endif
 } bitgen_t;
 
+#ifdef NUMPY_RANDOM_STATS
+#define BITGEN_COUNT_TRIAL(bitgen_state) ((bitgen_state)->rejection_trials++)
+#else
+#define BITGEN_COUNT_TRIAL(bitgen_state) ((void)0)
+#endif
+
 
 #endif  /* NUMPY_CORE_INCLUDE_NUMPY_RANDOM_BITGEN_H_ */
@@ -27,10 +27,40 @@ extern "C" {
 #define RAND_INT_MAX INT64_MAX
 #endif
 
-#if defined(_MSC_VER) && defined(DLL_EXPORT)
+/*
+ * With NUMPY_RANDOM_HEADER_ONLY numpy_random.h includes the kernel sources
+ * directly, every function then gets internal linkage in each including
+ * translation unit so the compiler can inline them into the engine callbacks.
+ */
+#if defined(NUMPY_RANDOM_HEADER_ONLY)
+#define DECLDIR static NPY_INLINE
+#define LOCALDIR static NPY_INLINE
+#elif defined(_MSC_VER) && defined(DLL_EXPORT)
 #define DECLDIR __declspec(dllexport)
+#define LOCALDIR
 #else
 #define DECLDIR extern
+#define LOCALDIR
+#endif
+
+/*
+ * Kernels whose loop the compiler can vectorize are built once per x86-64 ISA
+ * level and an ifunc resolver picks the best clone for the running CPU at load
+ * time. Only random_standard_uniform_fill_mantissas qualifies; the other fills
+ * make an indirect next_* call per value and gain nothing from a wider ISA.
+ * The sources are compiled with -ffp-contract=off so no clone fuses a multiply
+ * and an add, the output is bit-identical across them. Needs GCC 6+ or clang
+ * 14+ on an ELF target with ifunc support; define NUMPY_RANDOM_NO_DISPATCH to
+ * build the baseline only.
+ */
+#if !defined(NUMPY_RANDOM_NO_DISPATCH) && !defined(NUMPY_RANDOM_HEADER_ONLY) && \
+    defined(__x86_64__) && defined(__ELF__) && defined(__linux__) &&          \
+    ((defined(__clang__) && __clang_major__ >= 14) ||                         \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 6))
+#define NPY_RANDOM_DISPATCH \
+  __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#else
+#define NPY_RANDOM_DISPATCH
 #endif
 
 #ifndef MIN
@@ -62,9 +92,23 @@ typedef struct s_binomial_t {
   double p4;
 } binomial_t;
 
+/*
+ * Setup of the gamma samplers for one shape, filled by random_gamma_prepare.
+ * b and c are the Marsaglia-Tsang constants of shape >= 1, inv_shape the
+ * exponent of the shape < 1 method.
+ */
+typedef struct s_gamma_t {
+  double shape;
+  double b;
+  double c;
+  double inv_shape;
+} gamma_t;
+
 DECLDIR float random_standard_uniform_f(bitgen_t *bitgen_state);
 DECLDIR double random_standard_uniform(bitgen_t *bitgen_state);
 DECLDIR void random_standard_uniform_fill(bitgen_t *, npy_intp, double *);
+DECLDIR void random_standard_uniform_fill_mantissas(npy_intp, const uint64_t *,
+                                                    double *);
 DECLDIR void random_standard_uniform_fill_f(bitgen_t *, npy_intp, float *);
 
 DECLDIR int64_t random_positive_int64(bitgen_t *bitgen_state);
@@ -85,6 +129,11 @@ DECLDIR void random_standard_normal_fill(bitgen_t *, npy_intp, double *);
 DECLDIR void random_standard_normal_fill_f(bitgen_t *, npy_intp, float *);
 DECLDIR double random_standard_gamma(bitgen_t *bitgen_state, double shape);
 DECLDIR float random_standard_gamma_f(bitgen_t *bitgen_state, float shape);
+DECLDIR void random_gamma_prepare(gamma_t *gamma, double shape);
+DECLDIR double random_standard_gamma_prepared(bitgen_t *bitgen_state,
+                                              const gamma_t *gamma);
+DECLDIR void random_standard_gamma_fill(bitgen_t *, const gamma_t *, npy_intp,
+                                        double *);
 
 DECLDIR double random_normal(bitgen_t *bitgen_state, double loc, double scale);
 
@@ -169,6 +218,12 @@ DECLDIR void random_bounded_bool_fill(bitgen_t *bitgen_state, npy_bool off,
                                       npy_bool rng, npy_intp cnt,
                                       bool use_masked, npy_bool *out);
 
+/* Bernoulli(p) fills, bit-sliced 64 variates per block. */
+DECLDIR void random_bernoulli_fill(bitgen_t *bitgen_state, double p,
+                                   npy_intp cnt, npy_bool *out);
+DECLDIR void random_bernoulli_fill_packed(bitgen_t *bitgen_state, double p,
+                                          npy_intp cnt, uint64_t *out);
+
 DECLDIR void random_multinomial(bitgen_t *bitgen_state, RAND_INT_TYPE n, RAND_INT_TYPE *mnix,
                                 double *pix, npy_intp d, binomial_t *binomial);
 
@@ -188,15 +243,16 @@ DECLDIR void random_multivariate_hypergeometric_marginals(bitgen_t *bitgen_state
 
 /* Common to legacy-distributions.c and distributions.c but not exported */
 
-RAND_INT_TYPE random_binomial_btpe(bitgen_t *bitgen_state,
-                                   RAND_INT_TYPE n,
-                                   double p,
-                                   binomial_t *binomial);
-RAND_INT_TYPE random_binomial_inversion(bitgen_t *bitgen_state,
-                                        RAND_INT_TYPE n,
-                                        double p,
-                                        binomial_t *binomial);
-double random_loggam(double x);
+LOCALDIR RAND_INT_TYPE random_binomial_btpe(bitgen_t *bitgen_state,
+                                            RAND_INT_TYPE n,
+                                            double p,
+                                            binomial_t *binomial);
+LOCALDIR RAND_INT_TYPE random_binomial_inversion(bitgen_t *bitgen_state,
+                                                 RAND_INT_TYPE n,
+                                                 double p,
+                                                 binomial_t *binomial);
+LOCALDIR int64_t random_geometric_inversion(bitgen_t *bitgen_state, double p);
+LOCALDIR double random_loggam(double x);
 static NPY_INLINE double next_double(bitgen_t *bitgen_state) {
     return bitgen_state->next_double(bitgen_state->state);
 }
@@ -7,6 +7,7 @@
 #endif
 
 #include <assert.h>
+#include <string.h>
 
 /* Inline generators for internal use */
 static NPY_INLINE uint32_t next_uint32(bitgen_t *bitgen_state) {
@@ -36,6 +37,32 @@ void random_standard_uniform_fill(bitgen_t *bitgen_state, npy_intp cnt, double *
   }
 }
 
+/*
+ * out[i] = mantissas[i] * 2^-53 for mantissas below 2^53, the step from raw
+ * words to the doubles of next_double. RandomState draws a block of
+ * mantissas from its engine and converts it here. The double is assembled
+ * from bits, 1 + (m >> 1) * 2^-52 minus 1 plus the low bit as 2^-53 or 0,
+ * which is exact and needs only 64 bit integer ops and one add, so every
+ * clone vectorizes it, where an int64 to double conversion would need
+ * AVX-512DQ.
+ */
+NPY_RANDOM_DISPATCH
+void random_standard_uniform_fill_mantissas(npy_intp cnt,
+                                            const uint64_t *mantissas,
+                                            double *out) {
+  npy_intp i;
+  uint64_t hi_bits, lo_bits;
+  double hi, lo;
+
+  for (i = 0; i < cnt; i++) {
+    hi_bits = 0x3FF0000000000000ULL | (mantissas[i] >> 1);
+    lo_bits = (0 - (mantissas[i] & 1)) & 0x3CA0000000000000ULL;
+    memcpy(&hi, &hi_bits, sizeof(hi));
+    memcpy(&lo, &lo_bits, sizeof(lo));
+    out[i] = (hi - 1.0) + lo;
+  }
+}
+
 void random_standard_uniform_fill_f(bitgen_t *bitgen_state, npy_intp cnt, float *out) {
   npy_intp i;
   for (i = 0; i < cnt; i++) {
@@ -72,11 +99,49 @@ double random_standard_exponential(bitgen_t *bitgen_state) {
   return standard_exponential_unlikely(bitgen_state, idx, x);
 }
 
+#define EXPONENTIAL_FILL_CHUNK 256
+
+/*
+ * Same values as cnt calls of random_standard_exponential, a chunk at a time
+ * in two passes. The first pass takes the words in stream order and only does
+ * the integer part of the accept test, a rejected draw runs
+ * standard_exponential_unlikely right there so it consumes exactly the words
+ * of the scalar loop and its value is put aside. The second pass is the
+ * gather from we_double and the multiply for the whole chunk, a plain loop
+ * the compiler may turn into vector gathers, and then the put aside values
+ * are written back. There is no explicit SIMD ziggurat.
+ */
 void random_standard_exponential_fill(bitgen_t * bitgen_state, npy_intp cnt, double * out)
 {
-  npy_intp i;
-  for (i = 0; i < cnt; i++) {
-    out[i] = random_standard_exponential(bitgen_state);
+  uint64_t ri[EXPONENTIAL_FILL_CHUNK];
+  uint8_t idx[EXPONENTIAL_FILL_CHUNK];
+  npy_intp rejected_pos[EXPONENTIAL_FILL_CHUNK];
+  double rejected[EXPONENTIAL_FILL_CHUNK];
+  npy_intp i, j, n, n_rejected;
+  uint64_t r;
+  uint8_t k;
+
+  for (i = 0; i < cnt; i += EXPONENTIAL_FILL_CHUNK) {
+    n = MIN(cnt - i, EXPONENTIAL_FILL_CHUNK);
+    n_rejected = 0;
+    for (j = 0; j < n; j++) {
+      r = next_uint64(bitgen_state) >> 3;
+      k = r & 0xFF;
+      r >>= 8;
+      ri[j] = r;
+      idx[j] = k;
+      if (r >= ke_double[k]) {
+        rejected_pos[n_rejected] = j;
+        rejected[n_rejected++] =
+            standard_exponential_unlikely(bitgen_state, k, r * we_double[k]);
+      }
+    }
+    for (j = 0; j < n; j++) {
+      out[i + j] = ri[j] * we_double[idx[j]];
+    }
+    for (j = 0; j < n_rejected; j++) {
+      out[i + rejected_pos[j]] = rejected[j];
+    }
   }
 }
 
@@ -217,9 +282,23 @@ void random_standard_normal_fill_f(bitgen_t *bitgen_state, npy_intp cnt, float *
   }
 }
 
+void random_gamma_prepare(gamma_t *gamma, double shape) {
+  gamma->shape = shape;
+  gamma->b = shape - 1. / 3.;
+  gamma->c = 1. / sqrt(9 * gamma->b);
+  gamma->inv_shape = 1. / shape;
+}
+
 double random_standard_gamma(bitgen_t *bitgen_state,
                                             double shape) {
-  double b, c;
+  gamma_t gamma;
+  random_gamma_prepare(&gamma, shape);
+  return random_standard_gamma_prepared(bitgen_state, &gamma);
+}
+
+double random_standard_gamma_prepared(bitgen_t *bitgen_state,
+                                      const gamma_t *gamma) {
+  double shape = gamma->shape, b = gamma->b, c = gamma->c;
   double U, V, X, Y;
 
   if (shape == 1.0) {
@@ -231,21 +310,19 @@ double random_standard_gamma(bitgen_t *bitgen_state,
       U = next_double(bitgen_state);
       V = random_standard_exponential(bitgen_state);
       if (U <= 1.0 - shape) {
-        X = pow(U, 1. / shape);
+        X = pow(U, gamma->inv_shape);
         if (X <= V) {
           return X;
         }
       } else {
         Y = -log((1 - U) / shape);
-        X = pow(1.0 - shape + shape * Y, 1. / shape);
+        X = pow(1.0 - shape + shape * Y, gamma->inv_shape);
         if (X <= (V + Y)) {
           return X;
         }
       }
     }
   } else {
-    b = shape - 1. / 3.;
-    c = 1. / sqrt(9 * b);
     for (;;) {
       do {
         X = random_standard_normal(bitgen_state);
@@ -263,6 +340,65 @@ double random_standard_gamma(bitgen_t *bitgen_state,
   }
 }
 
+#define GAMMA_FILL_CHUNK 256
+
+/*
+ * Same values as cnt calls of random_standard_gamma_prepared. For shape > 1
+ * the (X, U) pairs of the Marsaglia-Tsang loop are drawn a chunk at a time in
+ * stream order, then the squeeze test runs over the whole chunk, the log test
+ * only on the pairs the squeeze did not accept, and the accepted pairs are
+ * compacted into out in order. A rejected pair is followed by the next pair in
+ * the stream either way, and a chunk never holds more pairs than values still
+ * missing, so exactly the scalar loop's words are consumed.
+ */
+void random_standard_gamma_fill(bitgen_t *bitgen_state, const gamma_t *gamma,
+                                npy_intp cnt, double *out) {
+  double X[GAMMA_FILL_CHUNK], V[GAMMA_FILL_CHUNK], U[GAMMA_FILL_CHUNK];
+  npy_bool accept[GAMMA_FILL_CHUNK];
+  double b = gamma->b, c = gamma->c;
+  double x, v;
+  npy_intp i, j, n, done;
+
+  if (gamma->shape == 1.0) {
+    random_standard_exponential_fill(bitgen_state, cnt, out);
+    return;
+  } else if (!(gamma->shape > 1.0)) {
+    for (i = 0; i < cnt; i++) {
+      out[i] = random_standard_gamma_prepared(bitgen_state, gamma);
+    }
+    return;
+  }
+
+  done = 0;
+  while (done < cnt) {
+    n = MIN(cnt - done, GAMMA_FILL_CHUNK);
+    for (j = 0; j < n; j++) {
+      do {
+        x = random_standard_normal(bitgen_state);
+        v = 1.0 + c * x;
+      } while (v <= 0.0);
+      X[j] = x;
+      V[j] = v;
+      U[j] = next_double(bitgen_state);
+    }
+    for (j = 0; j < n; j++) {
+      V[j] = V[j] * V[j] * V[j];
+      accept[j] = U[j] < 1.0 - 0.0331 * (X[j] * X[j]) * (X[j] * X[j]);
+    }
+    for (j = 0; j < n; j++) {
+      if (!accept[j]) {
+        /* log(0.0) ok here */
+        accept[j] = log(U[j]) < 0.5 * X[j] * X[j] + b * (1. - V[j] + log(V[j]));
+      }
+    }
+    for (j = 0; j < n; j++) {
+      if (accept[j]) {
+        out[done++] = b * V[j];
+      }
+    }
+  }
+}
+
 float random_standard_gamma_f(bitgen_t *bitgen_state,
                                              float shape) {
   float b, c;
@@ -411,6 +547,7 @@ double random_beta(bitgen_t *bitgen_state, double a, double b) {
     /* Use Johnk's algorithm */
 
     while (1) {
+      BITGEN_COUNT_TRIAL(bitgen_state);
       U = next_double(bitgen_state);
       V = next_double(bitgen_state);
       X = pow(U, 1.0 / a);
@@ -638,6 +775,7 @@ RAND_INT_TYPE random_binomial_btpe(bitgen_t *bitgen_state, RAND_INT_TYPE n,
 
 /* sigh ... */
 Step10:
+  BITGEN_COUNT_TRIAL(bitgen_state);
   nrq = n * r * q;
   u = next_double(bitgen_state) * p4;
   v = next_double(bitgen_state);
@@ -979,6 +1117,7 @@ RAND_INT_TYPE random_zipf(bitgen_t *bitgen_state, double a) {
   while (1) {
     double T, U, V, X;
 
+    BITGEN_COUNT_TRIAL(bitgen_state);
     U = 1.0 - next_double(bitgen_state);
     V = next_double(bitgen_state);
     X = floor(pow(U, -1.0 / am1));
@@ -1669,6 +1808,83 @@ void random_bounded_bool_fill(bitgen_t *bitgen_state, npy_bool off,
   }
 }
 
+/*
+ * Draws 64 Bernoulli(p) variates at once, one per bit. Every bit lane holds
+ * a uniform U whose binary digits are drawn one word at a time and compared
+ * against the binary expansion of p; a lane is decided at the first digit
+ * where the two differ and U < p iff that digit of p is 1. A lane only needs
+ * 2 digits on average, so the block stops after ~log2(64) + 2 words.
+ *
+ * Doubling q and subtracting 1 is exact for q in [0, 2), so the expansion of
+ * p is walked exactly; once it runs out the remaining lanes have U >= p.
+ */
+static NPY_INLINE uint64_t bernoulli_block(bitgen_t *bitgen_state, double p) {
+  uint64_t undecided = ~(uint64_t)0;
+  uint64_t result = 0;
+  uint64_t w;
+  double q = p;
+
+  while (undecided && q != 0.0) {
+    w = next_uint64(bitgen_state);
+    q += q;
+    if (q >= 1.0) {
+      result |= undecided & ~w;
+      undecided &= w;
+      q -= 1.0;
+    } else {
+      undecided &= ~w;
+    }
+  }
+  return result;
+}
+
+/*
+ * Fills an array with cnt Bernoulli(p) variates stored as 0/1 bytes. Output
+ * i is bit (i % 64) of block (i / 64), the same layout as
+ * random_bernoulli_fill_packed(...), so both consume identical streams.
+ */
+void random_bernoulli_fill(bitgen_t *bitgen_state, double p, npy_intp cnt,
+                           npy_bool *out) {
+  npy_intp i, j, n;
+  uint64_t block;
+
+  if (!(p > 0.0) || p >= 1.0) {
+    for (i = 0; i < cnt; i++) {
+      out[i] = (p >= 1.0);
+    }
+    return;
+  }
+  for (i = 0; i < cnt; i += 64) {
+    block = bernoulli_block(bitgen_state, p);
+    n = MIN(cnt - i, 64);
+    for (j = 0; j < n; j++) {
+      out[i + j] = (npy_bool)((block >> j) & 0x1);
+    }
+  }
+}
+
+/*
+ * Fills (cnt + 63) / 64 words with cnt Bernoulli(p) variates packed one per
+ * bit, least significant bit first. Unused bits of the last word are zero.
+ */
+void random_bernoulli_fill_packed(bitgen_t *bitgen_state, double p,
+                                  npy_intp cnt, uint64_t *out) {
+  npy_intp i, nwords = (cnt + 63) / 64;
+
+  if (!(p > 0.0) || p >= 1.0) {
+    for (i = 0; i < nwords; i++) {
+      out[i] = (p >= 1.0) ? ~(uint64_t)0 : 0;
+    }
+  } else {
+    for (i = 0; i < nwords; i++) {
+      out[i] = bernoulli_block(bitgen_state, p);
+    }
+  }
+  if (cnt % 64) {
+    out[nwords - 1] &= ((uint64_t)1 << (cnt % 64)) - 1;
+  }
+}
+
 void random_multinomial(bitgen_t *bitgen_state, RAND_INT_TYPE n,
                         RAND_INT_TYPE *mnix, double *pix, npy_intp d,
                         binomial_t *binomial) {
@@ -4,6 +4,10 @@
 
 #include <stdint.h>
 
+#ifdef NUMPY_RANDOM_HEADER_ONLY
+static inline double logfactorial(int64_t k);
+#else
 double logfactorial(int64_t k);
+#endif
 
 #endif
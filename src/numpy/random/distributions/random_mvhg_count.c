@@ -71,7 +71,7 @@ int random_multivariate_hypergeometric_count(bitgen_t *bitgen_state,
         return 0;
     }
 
-    choices = malloc(total * (sizeof *choices));
+    choices = (size_t *)malloc(total * (sizeof *choices));
     if (choices == NULL) {
         return -1;
     }
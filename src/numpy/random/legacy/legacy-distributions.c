@@ -25,6 +25,7 @@ double legacy_gauss(aug_bitgen_t *aug_state) {
     double f, x1, x2, r2;
 
     do {
+      BITGEN_COUNT_TRIAL(aug_state->bit_generator);
       x1 = 2.0 * legacy_double(aug_state) - 1.0;
       x2 = 2.0 * legacy_double(aug_state) - 1.0;
       r2 = x1 * x1 + x2 * x2;
@@ -44,8 +45,33 @@ double legacy_standard_exponential(aug_bitgen_t *aug_state) {
   return -log(1.0 - legacy_double(aug_state));
 }
 
+/*
+ * cnt values of legacy_standard_exponential. The uniforms are drawn first and
+ * -log(1 - U) is taken over the whole buffer afterwards with libm's scalar log,
+ * one call per value, so the values are bit-identical to the scalar function.
+ * This only saves the per draw call overhead, it is not vectorized: there is
+ * no SIMD log here that is known to round like libm.
+ */
+void legacy_standard_exponential_fill(aug_bitgen_t *aug_state, npy_intp cnt,
+                                      double *out) {
+  npy_intp i;
+  for (i = 0; i < cnt; i++) {
+    out[i] = legacy_double(aug_state);
+  }
+  for (i = 0; i < cnt; i++) {
+    out[i] = -log(1.0 - out[i]);
+  }
+}
+
 double legacy_standard_gamma(aug_bitgen_t *aug_state, double shape) {
-  double b, c;
+  gamma_t gamma;
+  random_gamma_prepare(&gamma, shape);
+  return legacy_standard_gamma_prepared(aug_state, &gamma);
+}
+
+double legacy_standard_gamma_prepared(aug_bitgen_t *aug_state,
+                                      const gamma_t *gamma) {
+  double shape = gamma->shape, b = gamma->b, c = gamma->c;
   double U, V, X, Y;
 
   if (shape == 1.0) {
@@ -55,25 +81,25 @@ double legacy_standard_gamma(aug_bitgen_t *aug_state, double shape) {
     return 0.0;
   } else if (shape < 1.0) {
     for (;;) {
+      BITGEN_COUNT_TRIAL(aug_state->bit_generator);
       U = legacy_double(aug_state);
       V = legacy_standard_exponential(aug_state);
       if (U <= 1.0 - shape) {
-        X = pow(U, 1. / shape);
+        X = pow(U, gamma->inv_shape);
         if (X <= V) {
           return X;
         }
       } else {
         Y = -log((1 - U) / shape);
-        X = pow(1.0 - shape + shape * Y, 1. / shape);
+        X = pow(1.0 - shape + shape * Y, gamma->inv_shape);
         if (X <= (V + Y)) {
           return X;
         }
       }
     }
   } else {
-    b = shape - 1. / 3.;
-    c = 1. / sqrt(9 * b);
     for (;;) {
+      BITGEN_COUNT_TRIAL(aug_state->bit_generator);
       do {
         X = legacy_gauss(aug_state);
         V = 1.0 + c * X;
@@ -89,6 +115,22 @@ double legacy_standard_gamma(aug_bitgen_t *aug_state, double shape) {
   }
 }
 
+/*
+ * cnt values of legacy_standard_gamma_prepared, the setup in gamma is shared
+ * by the whole fill.
+ */
+void legacy_standard_gamma_fill(aug_bitgen_t *aug_state, const gamma_t *gamma,
+                                npy_intp cnt, double *out) {
+  npy_intp i;
+  if (gamma->shape == 1.0) {
+    legacy_standard_exponential_fill(aug_state, cnt, out);
+    return;
+  }
+  for (i = 0; i < cnt; i++) {
+    out[i] = legacy_standard_gamma_prepared(aug_state, gamma);
+  }
+}
+
 double legacy_gamma(aug_bitgen_t *aug_state, double shape, double scale) {
   return scale * legacy_standard_gamma(aug_state, shape);
 }
@@ -193,6 +235,7 @@ double legacy_beta(aug_bitgen_t *aug_state, double a, double b) {
     /* Use Johnk's algorithm */
 
     while (1) {
+      BITGEN_COUNT_TRIAL(aug_state->bit_generator);
       U = legacy_double(aug_state);
       V = legacy_double(aug_state);
       X = pow(U, 1.0 / a);
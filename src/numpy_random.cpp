@@ -1,5 +1,6 @@
 ﻿#include <cassert>
 #include <iostream>
+#include <new>
 #include "numpy_random.h"
 
 extern "C" {
@@ -8,55 +9,72 @@ extern "C" {
 #include "numpy/random/legacy/legacy-distributions.h"
 }
 
-void internal_random_state::init(void* raw_engine, uint64_t (*next_uint64)(void* st),
-                                 uint32_t (*next_uint32)(void* st), double (*next_double)(void* st),
-                                 uint64_t (*next_raw)(void* st)) {
-    _bitgen = (bitgen_t*)malloc(sizeof(bitgen_t));
-    if (_bitgen == nullptr) {
-        return;
-    }
-
+static_assert(sizeof(bitgen_t) <= internal_random_state::AUG_STATE_OFFSET -
+                                      internal_random_state::BITGEN_OFFSET,
+              "bitgen_t does not fit its slot in internal_random_state::_storage");
+static_assert(sizeof(aug_bitgen_t) <= internal_random_state::BINOMIAL_OFFSET -
+                                          internal_random_state::AUG_STATE_OFFSET,
+              "aug_bitgen_t does not fit its slot in internal_random_state::_storage");
+static_assert(sizeof(binomial_t) <= internal_random_state::STORAGE_SIZE -
+                                        internal_random_state::BINOMIAL_OFFSET,
+              "binomial_t does not fit its slot in internal_random_state::_storage");
+
+NUMPY_RANDOM_INLINE void internal_random_state::init(void* raw_engine,
+                                                     uint64_t (*next_uint64)(void* st),
+                                                     uint32_t (*next_uint32)(void* st),
+                                                     double (*next_double)(void* st),
+                                                     uint64_t (*next_raw)(void* st)) {
+    _bitgen = new (&_storage[BITGEN_OFFSET]) bitgen_t{};
     _bitgen->state = raw_engine;
     _bitgen->next_uint64 = next_uint64;
     _bitgen->next_uint32 = next_uint32;
     _bitgen->next_double = next_double;
     _bitgen->next_raw = next_raw;
 
-    _aug_state = (aug_bitgen_t*)malloc(sizeof(aug_bitgen_t));
-    if (_aug_state == nullptr) {
-        return;
-    }
-
+    _aug_state = new (&_storage[AUG_STATE_OFFSET]) aug_bitgen_t{};
     _aug_state->bit_generator = _bitgen;
     _aug_state->has_gauss = 0;
     _aug_state->gauss = 0.0;
 
-    _binomial = (binomial_t*)malloc(sizeof(binomial_t));
+    _binomial = new (&_storage[BINOMIAL_OFFSET]) binomial_t{};
 }
 
-void internal_random_state::uninit() {
-    if (_bitgen == nullptr) {
-        return;
-    }
-
-    free(_bitgen);
-    free(_aug_state);
-    free(_binomial);
+NUMPY_RANDOM_INLINE void internal_random_state::uninit() {
     _bitgen = nullptr;
     _aug_state = nullptr;
     _binomial = nullptr;
 }
 
-uint32_t INIT_A = 0x43b0d7e5;
-uint32_t MULT_A = 0x931e8875;
-uint32_t INIT_B = 0x8b51f9dd;
-uint32_t MULT_B = 0x58f38ded;
-uint32_t MIX_MULT_L = 0xca01f9dd;
-uint32_t MIX_MULT_R = 0x4973f715;
-uint32_t XSHIFT = sizeof(uint32_t) * 8 / 2;
-uint32_t MASK32 = 0xFFFFFFFF;
+NUMPY_RANDOM_INLINE void internal_random_state::copy_from(const internal_random_state& other,
+                                                          void* raw_engine) {
+    _bitgen = new (&_storage[BITGEN_OFFSET]) bitgen_t(*other._bitgen);
+    _bitgen->state = raw_engine;
+#ifdef NUMPY_RANDOM_STATS
+    _bitgen->rejection_trials = 0;
+#endif
+
+    _aug_state = new (&_storage[AUG_STATE_OFFSET]) aug_bitgen_t(*other._aug_state);
+    _aug_state->bit_generator = _bitgen;
 
-uint32_t hashmix(uint32_t value, uint32_t* hash_const) {
+    _binomial = new (&_storage[BINOMIAL_OFFSET]) binomial_t(*other._binomial);
+}
+
+#ifdef NUMPY_RANDOM_STATS
+NUMPY_RANDOM_INLINE uint64_t internal_random_state::rejection_trials() const {
+    return _bitgen->rejection_trials;
+}
+#endif
+
+NUMPY_RANDOM_INLINE uint32_t INIT_A = 0x43b0d7e5;
+NUMPY_RANDOM_INLINE uint32_t MULT_A = 0x931e8875;
+NUMPY_RANDOM_INLINE uint32_t INIT_B = 0x8b51f9dd;
+NUMPY_RANDOM_INLINE uint32_t MULT_B = 0x58f38ded;
+NUMPY_RANDOM_INLINE uint32_t MIX_MULT_L = 0xca01f9dd;
+NUMPY_RANDOM_INLINE uint32_t MIX_MULT_R = 0x4973f715;
+NUMPY_RANDOM_INLINE uint32_t XSHIFT = sizeof(uint32_t) * 8 / 2;
+NUMPY_RANDOM_INLINE uint32_t MASK32 = 0xFFFFFFFF;
+
+NUMPY_RANDOM_INLINE uint32_t hashmix(uint32_t value, uint32_t* hash_const) {
     value ^= hash_const[0];
     hash_const[0] *= MULT_A;
     value *= hash_const[0];
@@ -64,13 +82,13 @@ uint32_t hashmix(uint32_t value, uint32_t* hash_const) {
     return value;
 }
 
-uint32_t mix(uint32_t x, uint32_t y) {
+NUMPY_RANDOM_INLINE uint32_t mix(uint32_t x, uint32_t y) {
     uint32_t result = (MIX_MULT_L * x - MIX_MULT_R * y);
     result ^= result >> XSHIFT;
     return result;
 }
 
-uint32_t rand_range_low(uint32_t low, uint32_t high) {
+NUMPY_RANDOM_INLINE uint32_t rand_range_low(uint32_t low, uint32_t high) {
     uint32_t val;
     assert(low < high);
     assert(high - low <= RAND_MAX);
@@ -83,7 +101,7 @@ uint32_t rand_range_low(uint32_t low, uint32_t high) {
     return val / scale + low;
 }
 
-uint32_t rand_range(uint32_t low, uint32_t high) {
+NUMPY_RANDOM_INLINE uint32_t rand_range(uint32_t low, uint32_t high) {
     assert(high > low);
     uint32_t val;
     uint32_t range = high - low;
@@ -96,7 +114,7 @@ uint32_t rand_range(uint32_t low, uint32_t high) {
     return val + low;
 }
 
-std::vector<uint32_t> rand_uints(size_t count) {
+NUMPY_RANDOM_INLINE std::vector<uint32_t> rand_uints(size_t count) {
     std::vector<uint32_t> rands(count, 0);
     for (auto& r : rands) {
         r = rand_range(0, UINT32_MAX - 1);
@@ -104,14 +122,15 @@ std::vector<uint32_t> rand_uints(size_t count) {
     return rands;
 }
 
-internal_numpy_seed_sequence::internal_numpy_seed_sequence(size_t pool_size)
+NUMPY_RANDOM_INLINE internal_numpy_seed_sequence::internal_numpy_seed_sequence(size_t pool_size)
     : _pool(pool_size, 0), _last_hash_const(INIT_B) {}
 
-void internal_numpy_seed_sequence::set_entropy(std::vector<uint32_t>&& entropy) {
+NUMPY_RANDOM_INLINE void
+internal_numpy_seed_sequence::set_entropy(std::vector<uint32_t>&& entropy) {
     _entropy = entropy;
 }
 
-uint32_t internal_numpy_seed_sequence::generate() {
+NUMPY_RANDOM_INLINE uint32_t internal_numpy_seed_sequence::generate() {
     uint32_t hash_const = _last_hash_const;
 
     uint32_t state = _pool[_pool_idx];
@@ -129,17 +148,36 @@ uint32_t internal_numpy_seed_sequence::generate() {
     return state;
 }
 
-void internal_numpy_seed_sequence::mix_entropy() {
+NUMPY_RANDOM_INLINE internal_numpy_seed_sequence internal_numpy_seed_sequence::spawn() {
+    internal_numpy_seed_sequence child{_pool.size()};
+    child._entropy = _entropy;
+    child._spawn_key = _spawn_key;
+    child._spawn_key.push_back(_n_children_spawned++);
+    child.mix_entropy();
+    return child;
+}
+
+NUMPY_RANDOM_INLINE void internal_numpy_seed_sequence::mix_entropy() {
     size_t pool_size = _pool.size();
     if (_entropy.size() <= 0) {
         _entropy = rand_uints(pool_size);
     }
     uint32_t hash_const[1]{INIT_A};
-    size_t entropy_size = _entropy.size();
+
+    // Same as NumPy's get_assembled_entropy, the spawn key goes after the entropy padded to the
+    // pool size so that children never collide with a parent of longer entropy.
+    std::vector<uint32_t> entropy = _entropy;
+    if (_spawn_key.size() > 0) {
+        if (entropy.size() < pool_size) {
+            entropy.resize(pool_size, 0);
+        }
+        entropy.insert(entropy.end(), _spawn_key.begin(), _spawn_key.end());
+    }
+    size_t entropy_size = entropy.size();
 
     for (size_t i = 0; i < pool_size; i++) {
         if (i < entropy_size) {
-            _pool[i] = hashmix(_entropy[i], hash_const);
+            _pool[i] = hashmix(entropy[i], hash_const);
         }
         else {
             _pool[i] = hashmix(0, hash_const);
@@ -157,7 +195,7 @@ void internal_numpy_seed_sequence::mix_entropy() {
     for (size_t i_src = pool_size; i_src < entropy_size; i_src++) {
         for (size_t i_dst = 0; i_dst < pool_size; i_dst++) {
             if (i_src != i_dst) {
-                _pool[i_dst] = mix(_pool[i_dst], hashmix(_entropy[i_src], hash_const));
+                _pool[i_dst] = mix(_pool[i_dst], hashmix(entropy[i_src], hash_const));
             }
         }
     }
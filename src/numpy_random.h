@@ -1,10 +1,63 @@
 ﻿#pragma once
+#ifdef NUMPY_RANDOM_STATS
+#include <chrono>
+#endif
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
 #include <cstdint>
 #include <deque>
+#include <iterator>
 #include <mutex>
 #include <utility>
 #include <vector>
 
+/*
+With NUMPY_RANDOM_HEADER_ONLY defined the C kernels and numpy_random.cpp are compiled into every
+translation unit that includes this header, with internal linkage, so there is no library to link
+and the kernels can be inlined into the engine callbacks of each RandomState.
+*/
+#ifdef NUMPY_RANDOM_HEADER_ONLY
+#define NUMPY_RANDOM_INLINE inline
+
+extern "C" {
+#include "numpy/random/bitgen.h"
+#include "numpy/random/distributions.h"
+#include "numpy/random/legacy/legacy-distributions.h"
+
+#include "numpy/random/distributions/distributions.c"
+#include "numpy/random/distributions/logfactorial.c"
+#include "numpy/random/distributions/random_hypergeometric.c"
+#include "numpy/random/distributions/random_mvhg_count.c"
+#include "numpy/random/distributions/random_mvhg_marginals.c"
+#include "numpy/random/legacy/legacy-distributions.c"
+}
+
+namespace numpy_random_internel {
+using ::random_bounded_uint64_fill;
+using ::random_bounded_uint32_fill;
+using ::random_bounded_uint16_fill;
+using ::random_bounded_uint8_fill;
+using ::random_bounded_bool_fill;
+using ::random_bernoulli_fill;
+using ::random_bernoulli_fill_packed;
+
+using ::random_uniform;
+using ::random_standard_uniform_fill;
+using ::random_standard_uniform_fill_mantissas;
+using ::random_standard_normal_fill;
+using ::random_standard_exponential_fill;
+
+using ::legacy_beta;
+using ::legacy_random_binomial;
+using ::legacy_gauss;
+using ::legacy_gamma;
+using ::legacy_standard_exponential_fill;
+} // namespace numpy_random_internel
+#else
+#define NUMPY_RANDOM_INLINE
+
 struct bitgen;
 struct aug_bitgen;
 struct s_binomial_t;
@@ -21,14 +74,107 @@ void random_bounded_uint8_fill(bitgen* bitgen_state, uint8_t off, uint8_t rng, i
                                bool use_masked, uint8_t* out);
 void random_bounded_bool_fill(bitgen* bitgen_state, unsigned char off, unsigned char rng,
                               intptr_t cnt, bool use_masked, unsigned char* out);
+void random_bernoulli_fill(bitgen* bitgen_state, double p, intptr_t cnt, unsigned char* out);
+void random_bernoulli_fill_packed(bitgen* bitgen_state, double p, intptr_t cnt, uint64_t* out);
 
 double random_uniform(bitgen* bitgen_state, double lower, double range);
+void random_standard_uniform_fill(bitgen* bitgen_state, intptr_t cnt, double* out);
+void random_standard_uniform_fill_mantissas(intptr_t cnt, const uint64_t* mantissas, double* out);
+void random_standard_normal_fill(bitgen* bitgen_state, intptr_t cnt, double* out);
+void random_standard_exponential_fill(bitgen* bitgen_state, intptr_t cnt, double* out);
 
 double legacy_beta(aug_bitgen* aug_state, double a, double b);
 int64_t legacy_random_binomial(bitgen* bitgen_state, double p, int64_t n, s_binomial_t* binomial);
 double legacy_gauss(aug_bitgen* aug_state);
+double legacy_gamma(aug_bitgen* aug_state, double shape, double scale);
+void legacy_standard_exponential_fill(aug_bitgen* aug_state, intptr_t cnt, double* out);
 }
 } // namespace numpy_random_internel
+#endif
+
+/*
+Snapshot returned by RandomState::stats. The counters are only kept when built with
+NUMPY_RANDOM_STATS (cmake -DNUMPY_RANDOM_STATS=ON), otherwise everything stays 0 and the hot paths
+are untouched.
+*/
+struct RandomStateStats {
+    enum method : size_t {
+        beta,
+        binomial,
+        gamma,
+        uniform,
+        rand_int,
+        rand_n,
+        standard_uniform_fill,
+        standard_normal_fill,
+        uint64_fill,
+        bernoulli_fill,
+        bernoulli_fill_packed,
+        standard_exponential_fill,
+        exponential_fill,
+        with_bitgen,
+        n_methods
+    };
+
+    static constexpr const char* method_names[n_methods] = {
+        "beta", "binomial", "gamma", "uniform", "rand_int", "rand_n", "standard_uniform_fill",
+        "standard_normal_fill", "uint64_fill", "bernoulli_fill", "bernoulli_fill_packed",
+        "standard_exponential_fill", "exponential_fill", "with_bitgen"};
+
+    uint64_t calls[n_methods] = {};
+    /* Engine outputs consumed, container engines count one per 64 bit word. */
+    uint64_t raw_words = 0;
+    /* Iterations of the rejection loops (Johnk, BTPE, Zipf, gamma, polar gauss) including the
+    accepted one, so rejection_trials - calls is the number of rejections. */
+    uint64_t rejection_trials = 0;
+    uint64_t lock_acquisitions = 0;
+    uint64_t lock_contentions = 0;
+    uint64_t lock_wait_ns = 0;
+};
+
+namespace numpy_random_internel {
+#ifdef NUMPY_RANDOM_STATS
+/* std::mutex that records how often and how long lock() had to wait. The counters are only
+written while holding the lock. */
+class stats_mutex {
+public:
+    void lock() {
+        if (!_mutex.try_lock()) {
+            auto start = std::chrono::steady_clock::now();
+            _mutex.lock();
+            auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start);
+            _wait_ns += (uint64_t)waited.count();
+            _contentions++;
+        }
+        _acquisitions++;
+    }
+
+    bool try_lock() {
+        if (_mutex.try_lock()) {
+            _acquisitions++;
+            return true;
+        }
+        return false;
+    }
+
+    void unlock() {
+        _mutex.unlock();
+    }
+
+    uint64_t _acquisitions = 0;
+    uint64_t _contentions = 0;
+    uint64_t _wait_ns = 0;
+
+private:
+    std::mutex _mutex{};
+};
+
+using state_mutex = stats_mutex;
+#else
+using state_mutex = std::mutex;
+#endif
+} // namespace numpy_random_internel
 
 template <class SrcIter, class DestIter>
 SrcIter uneven_copy(SrcIter src_first, DestIter dest_first, DestIter dest_last, std::true_type) {
@@ -94,12 +240,12 @@ size_t uneven_copy_safe(const IdxRef& src, size_t src_size, DestIter dest_first,
     size_t idx = 0;
 
     while (dest_first != dest_last) {
-        if (idx >= src_size) {
-            return src_size;
-        }
-
-        if ((count++ % SCALE) == 0)
+        if ((count++ % SCALE) == 0) {
+            if (idx >= src_size) {
+                return src_size;
+            }
             value = src[idx++];
+        }
         else
             value >>= DEST_BITS;
 
@@ -146,10 +292,27 @@ private:
               uint32_t (*next_uint32)(void* st), double (*next_double)(void* st),
               uint64_t (*next_raw)(void* st));
     void uninit();
+    /* Copies the C structs of **other** and points them at **raw_engine** and our own storage. */
+    void copy_from(const internal_random_state& other, void* raw_engine);
+#ifdef NUMPY_RANDOM_STATS
+    uint64_t rejection_trials() const;
+#endif
 
+public:
+    /* Byte offsets of the C structs inside _storage, the sizes are checked in numpy_random.cpp. */
+    static constexpr size_t BITGEN_OFFSET = 0;
+    static constexpr size_t AUG_STATE_OFFSET = 64;
+    static constexpr size_t BINOMIAL_OFFSET = 128;
+    static constexpr size_t STORAGE_SIZE = 320;
+
+private:
     bitgen* _bitgen = nullptr;
     aug_bitgen* _aug_state = nullptr;
     s_binomial_t* _binomial = nullptr;
+
+    /* The three structs live here instead of on the heap, so constructing a RandomState never
+    allocates. The pointers above point into it. */
+    alignas(64) unsigned char _storage[STORAGE_SIZE];
 };
 
 template <class T>
@@ -162,18 +325,18 @@ template <class F, class T>
 struct _is_static_castable<F, T, decltype(static_cast<T>(std::declval<F>()))> : std::true_type {};
 
 template <class F, class T>
-_INLINE_VAR constexpr bool is_static_castable_v =
+inline constexpr bool is_static_castable_v =
     _is_static_castable<raw_type<F>, raw_type<T>>::value;
 
 template <class F, class T>
 struct is_static_castable : std::bool_constant<is_static_castable_v<F, T>> {};
 
 template <class T, class... Types>
-_INLINE_VAR constexpr bool is_any_static_castable_v =
+inline constexpr bool is_any_static_castable_v =
     std::disjunction_v<is_static_castable<T, Types>...>;
 
 template <class T>
-_INLINE_VAR constexpr bool is_arithmetic_castable_v =
+inline constexpr bool is_arithmetic_castable_v =
     is_any_static_castable_v<T, bool, char, signed char, unsigned char, wchar_t,
 #ifdef __cpp_char8_t
                              char8_t,
@@ -181,8 +344,171 @@ _INLINE_VAR constexpr bool is_arithmetic_castable_v =
                              char16_t, char32_t, short, unsigned short, int, unsigned int, long,
                              unsigned long, long long, unsigned long long>;
 
+namespace numpy_random_internel {
+/* Ranges with a std::data of T* and a std::size, eg. std::vector<T>, std::array<T, N>, T[N]. */
+template <typename Range, typename T, typename = void>
+struct is_contiguous_range_of : std::false_type {};
+
+template <typename Range, typename T>
+struct is_contiguous_range_of<
+    Range, T,
+    std::enable_if_t<std::is_same_v<decltype(std::data(std::declval<Range&>())), T*> &&
+                     std::is_integral_v<decltype(std::size(std::declval<Range&>()))>>>
+    : std::true_type {};
+
+/* Any range of assignable T, eg. std::deque<T> or std::list<T>. */
+template <typename Range, typename T, typename = void>
+struct is_range_of : std::false_type {};
+
+template <typename Range, typename T>
+struct is_range_of<
+    Range, T,
+    std::enable_if_t<
+        std::is_assignable_v<decltype(*std::begin(std::declval<Range&>())), T> &&
+        std::is_convertible_v<decltype(std::begin(std::declval<Range&>()) !=
+                                       std::end(std::declval<Range&>())),
+                              bool>>> : std::true_type {};
+} // namespace numpy_random_internel
+
+namespace numpy_random_internel {
+/*
+128 bit engine outputs RandomState splits into two words itself, low word first like the container
+path would, instead of pushing them through the word deque. Specialize it for a custom 128 bit
+type with `lo` and `hi`.
+*/
+template <typename T, typename = void>
+struct wide_word : std::false_type {};
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct wide_word<unsigned __int128> : std::true_type {
+    static uint64_t lo(unsigned __int128 value) {
+        return (uint64_t)value;
+    }
+
+    static uint64_t hi(unsigned __int128 value) {
+        return (uint64_t)(value >> 64);
+    }
+};
+#endif
+
+template <>
+struct wide_word<std::array<uint64_t, 2>> : std::true_type {
+    static uint64_t lo(const std::array<uint64_t, 2>& value) {
+        return value[0];
+    }
+
+    static uint64_t hi(const std::array<uint64_t, 2>& value) {
+        return value[1];
+    }
+};
+} // namespace numpy_random_internel
+
+/* End of a RandomStream, the stream never reaches it. */
+struct RandomStreamEnd {};
+
+/*
+Endless input range over a RandomState. **fill(T* out, size_t cnt)** refills a buffer of **block**
+values with one bulk call, one lock, and the iterator yields from it, so a range pipeline pays the
+lock and the indirect calls once per block instead of once per value. Values buffered but never
+read are lost to the RandomState.
+*/
+template <typename T, typename Fill>
+class RandomStream {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        iterator() = default;
+        explicit iterator(RandomStream* stream) : _stream(stream) {}
+
+        reference operator*() const {
+            return _stream->_buffer[_stream->_pos];
+        }
+
+        pointer operator->() const {
+            return &_stream->_buffer[_stream->_pos];
+        }
+
+        iterator& operator++() {
+            _stream->advance();
+            return *this;
+        }
+
+        void operator++(int) {
+            _stream->advance();
+        }
+
+        friend bool operator==(const iterator&, RandomStreamEnd) {
+            return false;
+        }
+
+        friend bool operator==(RandomStreamEnd, const iterator&) {
+            return false;
+        }
+
+        friend bool operator!=(const iterator&, RandomStreamEnd) {
+            return true;
+        }
+
+        friend bool operator!=(RandomStreamEnd, const iterator&) {
+            return true;
+        }
+
+    private:
+        RandomStream* _stream = nullptr;
+    };
+
+    RandomStream(Fill fill, size_t block)
+        : _fill(std::move(fill)), _buffer(block > 0 ? block : 1), _pos(_buffer.size()) {}
+
+    iterator begin() {
+        if (_pos >= _buffer.size()) {
+            refill();
+        }
+        return iterator{this};
+    }
+
+    RandomStreamEnd end() const {
+        return RandomStreamEnd{};
+    }
+
+    /* The next value, same as *begin() then ++. */
+    T operator()() {
+        if (_pos >= _buffer.size()) {
+            refill();
+        }
+        return _buffer[_pos++];
+    }
+
+private:
+    void advance() {
+        if (++_pos >= _buffer.size()) {
+            refill();
+        }
+    }
+
+    void refill() {
+        _fill(_buffer.data(), _buffer.size());
+        _pos = 0;
+    }
+
+private:
+    Fill _fill;
+    std::vector<T> _buffer;
+    size_t _pos;
+};
+
 template <typename RngEngine>
 class RandomState {
+    template <typename>
+    friend class RandomStatePool;
+
     template <typename, typename = void>
     struct has_bracket_overload : std::false_type {};
 
@@ -239,14 +565,63 @@ class RandomState {
         }
     }
 
-    using RngReturn = typename raw_type<decltype(std::declval<RngEngine>()())>;
-    static constexpr bool is_arithmetic = std::is_arithmetic_v<RngReturn>;
+    using RngReturn = raw_type<decltype(std::declval<RngEngine>()())>;
+    using wide = numpy_random_internel::wide_word<RngReturn>;
+    /* Checked first, unsigned __int128 counts as arithmetic in the GNU dialects. */
+    static constexpr bool is_wide = wide::value;
+    static constexpr bool is_arithmetic = std::is_arithmetic_v<RngReturn> && !is_wide;
     static constexpr bool is_container_arithmetic = valid_container<RngReturn>();
     static constexpr bool is_custom_arithmetic =
         is_arithmetic_castable_v<RngReturn> && valid_custom_arithmetic<RngReturn>();
 
+    template <typename, typename = void>
+    struct has_max_fn : std::false_type {};
+
+    template <typename T>
+    struct has_max_fn<T, std::void_t<decltype((T::max)())>> : std::true_type {};
+
+    /* std::mt19937 returns uint_fast32_t which is 64 bits wide on LP64 platforms, so trust the
+    engine's max() over the size of its return type when it has one. */
+    template <typename T>
+    static constexpr bool narrow_engine() {
+        if constexpr (is_arithmetic && has_max_fn<T>::value) {
+            return (uint64_t)(T::max)() <= 0xffffffffULL;
+        }
+        else {
+            return (is_arithmetic || is_custom_arithmetic) && sizeof(RngReturn) <= sizeof(uint32_t);
+        }
+    }
+
+    static constexpr bool is_32bit = narrow_engine<RngEngine>();
+
+    /* Plain structs rather than lambdas so the streams stay assignable, which the C++20 views
+    need. **offset** + **scale** * x is applied unless it is the identity. */
+    struct double_stream_fill {
+        RandomState* state;
+        void (RandomState::*fill)(double*, size_t);
+        double offset;
+        double scale;
+
+        void operator()(double* out, size_t cnt) const {
+            (state->*fill)(out, cnt);
+            if (offset != 0.0 || scale != 1.0) {
+                for (size_t i = 0; i < cnt; i++) {
+                    out[i] = offset + scale * out[i];
+                }
+            }
+        }
+    };
+
+    struct uint64_stream_fill {
+        RandomState* state;
+
+        void operator()(uint64_t* out, size_t cnt) const {
+            state->uint64_fill(out, cnt);
+        }
+    };
+
     static_assert(
-        is_arithmetic || is_container_arithmetic || is_custom_arithmetic,
+        is_wide || is_arithmetic || is_container_arithmetic || is_custom_arithmetic,
         "**RngEngine** must implement operator(), the return type can be an"
         "*arithmetic type* or an *arithmetic container type* or a *custom arithmetic type*"
         "which must implement *operator>>* and *operator&* and can be *explicitly/implicitly"
@@ -257,16 +632,61 @@ public:
         init();
     }
 
-    template <typename... Ts>
-    RandomState(Ts&&... args) : _engine{std::forward<Ts>(args)...} {
+    template <typename T, typename... Ts,
+              std::enable_if_t<sizeof...(Ts) != 0 || !std::is_same_v<raw_type<T>, RandomState>,
+                               bool> = true>
+    RandomState(T&& arg, Ts&&... args)
+        : _engine{std::forward<T>(arg), std::forward<Ts>(args)...} {
         init();
     }
 
+    /* Copies the engine, the buffered words and the C side state (cached gauss, binomial setup),
+    so the copy continues with exactly the draws the original would produce next. */
+    RandomState(const RandomState& other) {
+        std::lock_guard lock{other.mutex};
+        _engine = other._engine;
+        copy_buffers(other);
+        _internal_state.copy_from(other._internal_state, this);
+    }
+
+    /* **other** is left with a moved-from engine and no buffered words. */
+    RandomState(RandomState&& other) {
+        std::lock_guard lock{other.mutex};
+        _engine = std::move(other._engine);
+        move_buffers(other);
+        _internal_state.copy_from(other._internal_state, this);
+    }
+
+    RandomState& operator=(const RandomState& other) {
+        if (this != &other) {
+            std::scoped_lock lock{mutex, other.mutex};
+            _engine = other._engine;
+            copy_buffers(other);
+            _internal_state.copy_from(other._internal_state, this);
+        }
+        return *this;
+    }
+
+    RandomState& operator=(RandomState&& other) {
+        if (this != &other) {
+            std::scoped_lock lock{mutex, other.mutex};
+            _engine = std::move(other._engine);
+            move_buffers(other);
+            _internal_state.copy_from(other._internal_state, this);
+        }
+        return *this;
+    }
+
     ~RandomState() {
         std::lock_guard lock{mutex};
         _internal_state.uninit();
     }
     
+    /* Independent snapshot of this state, same as the copy constructor. */
+    RandomState clone() const {
+        return RandomState(*this);
+    }
+
     /* This is a very bad implementation, this doesn't garuntee thread safety, 
     because after returning the reference we can easily mutate it from different threads 
     this lock simply does nothing. */
@@ -275,26 +695,41 @@ public:
         return _engine;
     }
 
+    /* Runs **fn(bitgen*, aug_bitgen*, s_binomial_t*)** under the lock, for calling the C kernels
+    from `numpy/random/distributions.h` directly. */
+    template <typename Fn>
+    void with_bitgen(Fn&& fn) {
+        std::lock_guard lock{mutex};
+        count_call(RandomStateStats::with_bitgen);
+        fn(_internal_state._bitgen, _internal_state._aug_state, _internal_state._binomial);
+    }
+
     template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
     T beta(T a, T b) {
-        if (_internal_state._bitgen == nullptr || _internal_state._aug_state == nullptr) {
-            return (T)0;
-        }
         std::lock_guard lock{mutex};
-        return (T)legacy_beta(_internal_state._aug_state, (double)a, (double)b);
+        count_call(RandomStateStats::beta);
+        return (T)numpy_random_internel::legacy_beta(_internal_state._aug_state, (double)a, (double)b);
     }
 
     template <typename T, typename U,
               std::enable_if_t<std::is_arithmetic_v<T> && std::is_floating_point_v<U>, bool> = true>
     int64_t binomial(T n, U p) {
-        if (_internal_state._bitgen == nullptr || _internal_state._binomial == nullptr) {
-            return 0LL;
-        }
         std::lock_guard lock{mutex};
-        return legacy_random_binomial(_internal_state._bitgen, (double)p, (int64_t)n,
+        count_call(RandomStateStats::binomial);
+        return numpy_random_internel::legacy_random_binomial(_internal_state._bitgen, (double)p, (int64_t)n,
                                       _internal_state._binomial);
     }
 
+    /* Legacy Gamma(shape, scale), the values of numpy's `RandomState.gamma`. For many draws with
+    the same shape use a GammaSampler (`numpy_random_gamma.h`), it does the setup once. */
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+    T gamma(T shape, T scale) {
+        std::lock_guard lock{mutex};
+        count_call(RandomStateStats::gamma);
+        return (T)numpy_random_internel::legacy_gamma(_internal_state._aug_state, (double)shape,
+                                                      (double)scale);
+    }
+
     template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, bool> = true>
     T uniform(T high) {
         T low = (T)0;
@@ -306,10 +741,11 @@ public:
         double _low = (double)low;
         double _high = (double)high;
         double range = _high - _low;
-        if (!isfinite(range) || _internal_state._bitgen == nullptr) {
+        if (!std::isfinite(range)) {
             return (T)0;
         }
         std::lock_guard lock{mutex};
+        count_call(RandomStateStats::uniform);
         return (T)numpy_random_internel::random_uniform(_internal_state._bitgen, _low, range);
     }
 
@@ -321,23 +757,209 @@ public:
 
     template <typename T, std::enable_if_t<std::is_integral_v<T>, bool> = true>
     T rand_int(T low, T high) {
-        if (_internal_state._bitgen == nullptr) {
-            return (T)0;
-        }
         std::lock_guard lock{mutex};
-        return (T)random_bounded_fill(low, high - low, 1, true);
+        count_call(RandomStateStats::rand_int);
+        return (T)random_bounded_fill<T>(low, (T)(high - low), 1, true);
     }
 
     template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
     T rand_n() {
-        if (_internal_state._bitgen == nullptr || _internal_state._aug_state == nullptr) {
-            return (T)0;
-        }
         std::lock_guard lock{mutex};
+        count_call(RandomStateStats::rand_n);
         return (T)numpy_random_internel::legacy_gauss(_internal_state._aug_state);
     }
 
+    /* Counters since construction, all 0 unless built with NUMPY_RANDOM_STATS. */
+    RandomStateStats stats() const {
+        RandomStateStats snapshot{};
+#ifdef NUMPY_RANDOM_STATS
+        std::lock_guard lock{mutex};
+        snapshot = _stats;
+        snapshot.lock_acquisitions = mutex._acquisitions;
+        snapshot.lock_contentions = mutex._contentions;
+        snapshot.lock_wait_ns = mutex._wait_ns;
+        snapshot.rejection_trials = _internal_state.rejection_trials();
+#endif
+        return snapshot;
+    }
+
+    /* Fills **out** with **cnt** uniform draws in [0, 1) taken from the same stream as uniform. */
+    void standard_uniform_fill(double* out, size_t cnt) {
+        std::lock_guard lock{mutex};
+        count_call(RandomStateStats::standard_uniform_fill);
+        fill_doubles(out, cnt);
+    }
+
+    /* Fills **out** with **cnt** standard normal draws using the ziggurat method, this is NOT the
+    legacy polar method used by rand_n so the two streams differ. */
+    void standard_normal_fill(double* out, size_t cnt) {
+        std::lock_guard lock{mutex};
+        count_call(RandomStateStats::standard_normal_fill);
+        numpy_random_internel::random_standard_normal_fill(_internal_state._bitgen, (intptr_t)cnt,
+                                                           out);
+    }
+
+    /* Fills **out** with **cnt** standard exponential draws using the ziggurat method, like
+    standard_normal_fill this is not the legacy stream of exponential_fill. */
+    void standard_exponential_fill(double* out, size_t cnt) {
+        std::lock_guard lock{mutex};
+        count_call(RandomStateStats::standard_exponential_fill);
+        numpy_random_internel::random_standard_exponential_fill(_internal_state._bitgen,
+                                                                (intptr_t)cnt, out);
+    }
+
+    /* Fills **out** with **cnt** legacy exponential draws `scale * -log(1 - U)`, the values of
+    numpy's `RandomState.exponential(scale)`. The log is libm's scalar log, one call per value. */
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+    void exponential_fill(T scale, double* out, size_t cnt) {
+        std::lock_guard lock{mutex};
+        count_call(RandomStateStats::exponential_fill);
+        numpy_random_internel::legacy_standard_exponential_fill(_internal_state._aug_state,
+                                                                (intptr_t)cnt, out);
+        if ((double)scale != 1.0) {
+            for (size_t i = 0; i < cnt; i++) {
+                out[i] = (double)scale * out[i];
+            }
+        }
+    }
+
+    /* Fills **out** with **cnt** raw 64 bit words, the same words the distributions consume. */
+    void uint64_fill(uint64_t* out, size_t cnt) {
+        std::lock_guard lock{mutex};
+        count_call(RandomStateStats::uint64_fill);
+        for (size_t i = 0; i < cnt; i++) {
+            out[i] = next_uint64(this);
+        }
+    }
+
+    /* Fills **out** with **cnt** Bernoulli(p) draws stored as 0/1 bytes. */
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+    void bernoulli_fill(T p, uint8_t* out, size_t cnt) {
+        std::lock_guard lock{mutex};
+        count_call(RandomStateStats::bernoulli_fill);
+        numpy_random_internel::random_bernoulli_fill(_internal_state._bitgen, (double)p,
+                                                     (intptr_t)cnt, out);
+    }
+
+    /* Same draws as bernoulli_fill packed one per bit into (cnt + 63) / 64 words, LSB first. */
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+    void bernoulli_fill_packed(T p, uint64_t* out, size_t cnt) {
+        std::lock_guard lock{mutex};
+        count_call(RandomStateStats::bernoulli_fill_packed);
+        numpy_random_internel::random_bernoulli_fill_packed(_internal_state._bitgen, (double)p,
+                                                            (intptr_t)cnt, out);
+    }
+
+    /* Range overloads of the bulk fills. Contiguous ranges go to the kernel in one call, other
+    ranges, eg. std::deque, are filled a block at a time through a buffer. */
+    template <typename Range,
+              std::enable_if_t<numpy_random_internel::is_range_of<Range, double>::value,
+                               bool> = true>
+    void standard_uniform_fill(Range&& out) {
+        fill_range<double>(out, [this](double* buffer, size_t cnt) {
+            standard_uniform_fill(buffer, cnt);
+        });
+    }
+
+    template <typename Range,
+              std::enable_if_t<numpy_random_internel::is_range_of<Range, double>::value,
+                               bool> = true>
+    void standard_normal_fill(Range&& out) {
+        fill_range<double>(out, [this](double* buffer, size_t cnt) {
+            standard_normal_fill(buffer, cnt);
+        });
+    }
+
+    template <typename Range,
+              std::enable_if_t<numpy_random_internel::is_range_of<Range, double>::value,
+                               bool> = true>
+    void standard_exponential_fill(Range&& out) {
+        fill_range<double>(out, [this](double* buffer, size_t cnt) {
+            standard_exponential_fill(buffer, cnt);
+        });
+    }
+
+    template <typename T, typename Range,
+              std::enable_if_t<std::is_floating_point_v<T> &&
+                                   numpy_random_internel::is_range_of<Range, double>::value,
+                               bool> = true>
+    void exponential_fill(T scale, Range&& out) {
+        fill_range<double>(out, [this, scale](double* buffer, size_t cnt) {
+            exponential_fill(scale, buffer, cnt);
+        });
+    }
+
+    template <typename Range,
+              std::enable_if_t<numpy_random_internel::is_range_of<Range, uint64_t>::value,
+                               bool> = true>
+    void uint64_fill(Range&& out) {
+        fill_range<uint64_t>(out, [this](uint64_t* buffer, size_t cnt) {
+            uint64_fill(buffer, cnt);
+        });
+    }
+
+    template <typename T, typename Range,
+              std::enable_if_t<std::is_floating_point_v<T> &&
+                                   numpy_random_internel::is_range_of<Range, uint8_t>::value,
+                               bool> = true>
+    void bernoulli_fill(T p, Range&& out) {
+        fill_range<uint8_t>(out, [this, p](uint8_t* buffer, size_t cnt) {
+            bernoulli_fill(p, buffer, cnt);
+        });
+    }
+
+    /* Endless ranges refilled **block** values at a time through the bulk fills, eg.
+    `for (double x : random.normal_stream(0.0, 1.0))`. The stream refers to this RandomState. */
+    RandomStream<double, double_stream_fill> standard_uniform_stream(size_t block = 256) {
+        return {double_stream_fill{this, &RandomState::standard_uniform_fill, 0.0, 1.0}, block};
+    }
+
+    /* Same arithmetic as uniform(low, high). */
+    RandomStream<double, double_stream_fill> uniform_stream(double low, double high,
+                                                            size_t block = 256) {
+        return {double_stream_fill{this, &RandomState::standard_uniform_fill, low, high - low},
+                block};
+    }
+
+    /* Ziggurat normals like standard_normal_fill, not the legacy rand_n stream. */
+    RandomStream<double, double_stream_fill> standard_normal_stream(size_t block = 256) {
+        return {double_stream_fill{this, &RandomState::standard_normal_fill, 0.0, 1.0}, block};
+    }
+
+    RandomStream<double, double_stream_fill> normal_stream(double loc, double scale,
+                                                           size_t block = 256) {
+        return {double_stream_fill{this, &RandomState::standard_normal_fill, loc, scale}, block};
+    }
+
+    RandomStream<uint64_t, uint64_stream_fill> uint64_stream(size_t block = 256) {
+        return {uint64_stream_fill{this}, block};
+    }
+
 private:
+    template <typename T, typename Range, typename Fill>
+    void fill_range(Range& out, Fill&& fill) {
+        if constexpr (numpy_random_internel::is_contiguous_range_of<Range, T>::value) {
+            fill(std::data(out), (size_t)std::size(out));
+        }
+        else {
+            constexpr size_t BLOCK = 256;
+            T buffer[BLOCK];
+            auto it = std::begin(out);
+            auto last = std::end(out);
+            while (it != last) {
+                size_t cnt = 0;
+                auto block_first = it;
+                for (; cnt < BLOCK && it != last; ++it) {
+                    cnt++;
+                }
+                fill(buffer, cnt);
+                for (size_t i = 0; i < cnt; ++i, ++block_first) {
+                    *block_first = buffer[i];
+                }
+            }
+        }
+    }
+
     template <typename T = bool>
     inline bool random_bounded_fill(bool off, bool rng, intptr_t cnt, bool use_masked) {
         unsigned char out_val = 0;
@@ -386,6 +1008,22 @@ private:
         return (T)out_val;
     }
 
+    inline void count_call(RandomStateStats::method method) {
+#ifdef NUMPY_RANDOM_STATS
+        _stats.calls[method]++;
+#else
+        (void)method;
+#endif
+    }
+
+    inline void count_raw_words(uint64_t cnt) {
+#ifdef NUMPY_RANDOM_STATS
+        _stats.raw_words += cnt;
+#else
+        (void)cnt;
+#endif
+    }
+
     bool get_from_container(uint64_t& out) {
         if (_uintegers_cnt > 0) {
             _uintegers_cnt -= 1;
@@ -444,7 +1082,18 @@ private:
         auto& _uintegers_cnt = _this._uintegers_cnt;
         auto& _uintegers = _this._uintegers;
 
-        if constexpr (is_arithmetic) {
+        _this.count_raw_words(1);
+        if constexpr (is_wide) {
+            if (_this._has_wide_hi) {
+                _this._has_wide_hi = false;
+                return _this._wide_hi;
+            }
+            RngReturn value = _engine();
+            _this._wide_hi = wide::hi(value);
+            _this._has_wide_hi = true;
+            return wide::lo(value);
+        }
+        else if constexpr (is_arithmetic) {
             return (uint64_t)_engine();
         }
         else {
@@ -476,8 +1125,7 @@ private:
         typename T,
         std::enable_if_t<std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>, bool> = true>
     static inline T get(void* ptr) {
-        constexpr bool IS_32BIT =
-            (is_arithmetic || is_custom_arithmetic) && sizeof(RngReturn) <= sizeof(uint32_t);
+        constexpr bool IS_32BIT = is_32bit;
 
         auto& _this = *(RandomState<RngEngine>*)ptr;
         auto& _engine = _this._engine;
@@ -501,7 +1149,9 @@ private:
         }
         else {
             if constexpr (IS_32BIT) {
-                return (T)get_raw(ptr) << 32 | get_raw(ptr);
+                /* High word first, the operands of | are unsequenced. */
+                uint64_t hi = get_raw(ptr);
+                return (T)(hi << 32 | get_raw(ptr));
             }
             else {
                 return (T)get_raw(ptr);
@@ -522,11 +1172,13 @@ private:
             auto& _this = *(RandomState<RngEngine>*)ptr;
             auto& _engine = _this._engine;
 
-            if constexpr (sizeof(RngReturn) <= sizeof(uint32_t)) {
+            if constexpr (is_32bit) {
+                _this.count_raw_words(2);
                 int32_t a = _engine() >> 5, b = _engine() >> 6;
                 return (a * 67108864.0 + b) / 9007199254740992.0;
             }
             else {
+                _this.count_raw_words(1);
                 uint64_t rnd = (uint64_t)_engine();
                 return (double)((rnd >> 11) * (1.0 / 9007199254740992.0));
             }
@@ -541,7 +1193,63 @@ private:
         return get_raw(ptr);
     }
 
+    /* The doubles of **cnt** next_double calls. The engine is called directly, no bitgen
+    indirection, for a chunk of 53 bit mantissas, which the CPU dispatched
+    random_standard_uniform_fill_mantissas turns into doubles. Bit-identical to next_double. */
+    void fill_doubles(double* out, size_t cnt) {
+        constexpr size_t CHUNK = 256;
+        uint64_t mantissas[CHUNK];
+        for (size_t done = 0; done < cnt;) {
+            size_t n = cnt - done < CHUNK ? cnt - done : CHUNK;
+
+            if constexpr (is_arithmetic && is_32bit) {
+                /* a * 2^26 + b, 27 + 26 bits. */
+                for (size_t i = 0; i < n; i++) {
+                    uint64_t a = (uint32_t)_engine() >> 5, b = (uint32_t)_engine() >> 6;
+                    mantissas[i] = a << 26 | b;
+                }
+                count_raw_words(2 * n);
+            }
+            else if constexpr (is_arithmetic) {
+                for (size_t i = 0; i < n; i++) {
+                    mantissas[i] = (uint64_t)_engine() >> 11;
+                }
+                count_raw_words(n);
+            }
+            else {
+                for (size_t i = 0; i < n; i++) {
+                    mantissas[i] = get_raw(this) >> 11;
+                }
+            }
+            numpy_random_internel::random_standard_uniform_fill_mantissas((intptr_t)n, mantissas,
+                                                                          out + done);
+            done += n;
+        }
+    }
+
 private:
+    void copy_buffers(const RandomState& other) {
+        _has_integer = other._has_integer;
+        _uinteger = other._uinteger;
+        _uintegers_cnt = other._uintegers_cnt;
+        _uintegers = other._uintegers;
+        _has_wide_hi = other._has_wide_hi;
+        _wide_hi = other._wide_hi;
+    }
+
+    void move_buffers(RandomState& other) {
+        _has_integer = other._has_integer;
+        _uinteger = other._uinteger;
+        _uintegers_cnt = other._uintegers_cnt;
+        _uintegers = std::move(other._uintegers);
+        _has_wide_hi = other._has_wide_hi;
+        _wide_hi = other._wide_hi;
+        other._has_integer = false;
+        other._uintegers_cnt = 0;
+        other._uintegers.clear();
+        other._has_wide_hi = false;
+    }
+
     void init() {
         std::lock_guard lock{mutex};
         _internal_state.init(
@@ -560,7 +1268,15 @@ private:
     size_t _uintegers_cnt = 0;
     std::deque<uint64_t> _uintegers{};
 
-    mutable std::mutex mutex{};
+    /* High word of the last 128 bit output, returned by the next get_raw. */
+    bool _has_wide_hi = false;
+    uint64_t _wide_hi = 0;
+
+#ifdef NUMPY_RANDOM_STATS
+    RandomStateStats _stats{};
+#endif
+
+    mutable numpy_random_internel::state_mutex mutex{};
 };
 
 struct internal_numpy_seed_sequence {
@@ -572,9 +1288,12 @@ private:
     uint32_t generate();
     void set_entropy(std::vector<uint32_t>&&);
     void mix_entropy();
+    internal_numpy_seed_sequence spawn();
 
     std::vector<uint32_t> _pool;
     std::vector<uint32_t> _entropy;
+    std::vector<uint32_t> _spawn_key;
+    uint32_t _n_children_spawned = 0;
     size_t _pool_idx = 0;
     uint32_t _last_hash_const = 0;
 };
@@ -586,12 +1305,15 @@ order to get the same behaviour as the NumPy's implementation don't reuse the sa
 create a new instance after every generation. (Again this should be used to set the initial state of
 a RngEngine so one time use should be enough.)
 */
-template <typename result_type = unsigned int, size_t pool_size = 4>
+template <typename ResultType = unsigned int, size_t pool_size = 4>
 class NumpySeedSequence {
-    static_assert(std::is_same_v<result_type, uint32_t> || std::is_same_v<result_type, uint64_t>,
+    static_assert(std::is_same_v<ResultType, uint32_t> || std::is_same_v<ResultType, uint64_t>,
                   "**result_type** can only be uint32_t or uint64_t.");
 
 public:
+    /* Exposed so the standard engines accept this as a seed sequence in `seed(SeedSeq&)`. */
+    using result_type = ResultType;
+
     NumpySeedSequence() {
         _inner.mix_entropy();
     }
@@ -615,7 +1337,7 @@ public:
     }
 
     NumpySeedSequence(const std::vector<uint32_t>& entropy) {
-        _inner.set_entropy(std::move(entropy));
+        _inner.set_entropy(std::vector<uint32_t>(entropy));
         _inner.mix_entropy();
     }
 
@@ -663,7 +1385,20 @@ public:
         return generate();
     }
 
+    /* Same as NumPy's SeedSequence.spawn, children share the entropy and get an extended
+    spawn key, so they are independent from each other and from the parent. */
+    std::vector<NumpySeedSequence> spawn(size_t n_children) {
+        std::vector<NumpySeedSequence> children;
+        children.reserve(n_children);
+        for (size_t i = 0; i < n_children; i++) {
+            children.push_back(NumpySeedSequence(_inner.spawn()));
+        }
+        return children;
+    }
+
 private:
+    NumpySeedSequence(internal_numpy_seed_sequence&& inner) : _inner(std::move(inner)) {}
+
     result_type generate() {
         if constexpr (sizeof(result_type) <= sizeof(uint32_t)) {
             return (result_type)_inner.generate();
@@ -688,3 +1423,7 @@ private:
 private:
     internal_numpy_seed_sequence _inner{pool_size};
 };
+
+#ifdef NUMPY_RANDOM_HEADER_ONLY
+#include "numpy_random.cpp"
+#endif
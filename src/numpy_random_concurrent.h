@@ -0,0 +1,276 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "numpy_random.h"
+
+/*
+Drop-in replacement for a RandomState shared by many threads. Calls are routed by a hash of the
+calling thread's id to one of several independent RandomStates, each seeded from a spawned child of
+the given seed sequence, so threads mostly stop fighting over one mutex. It has the distribution,
+fill and with_bitgen methods of RandomState, not get_engine, clone or the stream ranges, which
+would tie the caller to one shard.
+
+Every shard counts the calls that found it already busy. Once a shard collects
+**contention_threshold** of those the number of active shards doubles, up to **max_shards** which
+are all created up front so growing never moves a shard another thread may be using.
+
+Which shard serves a call depends on thread scheduling, so unlike RandomState the values seen by a
+thread are NOT reproducible from the seed alone, use PrefetchingRandomState or parallel_fill for
+that.
+*/
+template <typename RngEngine>
+class ConcurrentRandomState {
+    struct alignas(64) shard {
+        std::unique_ptr<RandomState<RngEngine>> state;
+        std::atomic<uint32_t> busy{0};
+        std::atomic<uint64_t> contentions{0};
+        std::atomic<uint64_t> window{0};
+    };
+
+public:
+    /* The engine must be seedable from a seed sequence, eg. `std::mt19937::seed(SeedSeq&)`. A
+    **max_shards** of 0 means twice the hardware threads. */
+    template <typename result_type, size_t pool_size>
+    ConcurrentRandomState(NumpySeedSequence<result_type, pool_size>& seed_seq,
+                          size_t initial_shards = 1, size_t max_shards = 0,
+                          uint64_t contention_threshold = 1024)
+        : _threshold(contention_threshold > 0 ? contention_threshold : 1) {
+        if (max_shards == 0) {
+            max_shards = 2 * (size_t)std::thread::hardware_concurrency();
+        }
+        if (max_shards == 0) {
+            max_shards = 1;
+        }
+        if (initial_shards == 0) {
+            initial_shards = 1;
+        }
+        if (initial_shards > max_shards) {
+            initial_shards = max_shards;
+        }
+
+        _shards = std::vector<shard>(max_shards);
+        auto children = seed_seq.spawn(max_shards);
+        for (size_t i = 0; i < max_shards; i++) {
+            _shards[i].state.reset(new RandomState<RngEngine>());
+            _shards[i].state->get_engine().seed(children[i]);
+        }
+        _active.store(initial_shards, std::memory_order_release);
+    }
+
+    ConcurrentRandomState(const ConcurrentRandomState&) = delete;
+    ConcurrentRandomState& operator=(const ConcurrentRandomState&) = delete;
+
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+    T beta(T a, T b) {
+        return with_shard([&](RandomState<RngEngine>& state) { return state.beta(a, b); });
+    }
+
+    template <typename T, typename U,
+              std::enable_if_t<std::is_arithmetic_v<T> && std::is_floating_point_v<U>, bool> = true>
+    int64_t binomial(T n, U p) {
+        return with_shard([&](RandomState<RngEngine>& state) { return state.binomial(n, p); });
+    }
+
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+    T gamma(T shape, T scale) {
+        return with_shard([&](RandomState<RngEngine>& state) { return state.gamma(shape, scale); });
+    }
+
+    template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, bool> = true>
+    T uniform(T high) {
+        return with_shard([&](RandomState<RngEngine>& state) { return state.uniform(high); });
+    }
+
+    template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, bool> = true>
+    T uniform(T low, T high) {
+        return with_shard([&](RandomState<RngEngine>& state) { return state.uniform(low, high); });
+    }
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T>, bool> = true>
+    T rand_int(T high) {
+        return with_shard([&](RandomState<RngEngine>& state) { return state.rand_int(high); });
+    }
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T>, bool> = true>
+    T rand_int(T low, T high) {
+        return with_shard([&](RandomState<RngEngine>& state) { return state.rand_int(low, high); });
+    }
+
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+    T rand_n() {
+        return with_shard(
+            [&](RandomState<RngEngine>& state) { return state.template rand_n<T>(); });
+    }
+
+    void standard_uniform_fill(double* out, size_t cnt) {
+        with_shard([&](RandomState<RngEngine>& state) { state.standard_uniform_fill(out, cnt); });
+    }
+
+    void standard_normal_fill(double* out, size_t cnt) {
+        with_shard([&](RandomState<RngEngine>& state) { state.standard_normal_fill(out, cnt); });
+    }
+
+    void uint64_fill(uint64_t* out, size_t cnt) {
+        with_shard([&](RandomState<RngEngine>& state) { state.uint64_fill(out, cnt); });
+    }
+
+    void standard_exponential_fill(double* out, size_t cnt) {
+        with_shard(
+            [&](RandomState<RngEngine>& state) { state.standard_exponential_fill(out, cnt); });
+    }
+
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+    void exponential_fill(T scale, double* out, size_t cnt) {
+        with_shard(
+            [&](RandomState<RngEngine>& state) { state.exponential_fill(scale, out, cnt); });
+    }
+
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+    void bernoulli_fill(T p, uint8_t* out, size_t cnt) {
+        with_shard([&](RandomState<RngEngine>& state) { state.bernoulli_fill(p, out, cnt); });
+    }
+
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+    void bernoulli_fill_packed(T p, uint64_t* out, size_t cnt) {
+        with_shard(
+            [&](RandomState<RngEngine>& state) { state.bernoulli_fill_packed(p, out, cnt); });
+    }
+
+    /* Range overloads, the whole range is filled from one shard. */
+    template <typename Range,
+              std::enable_if_t<numpy_random_internel::is_range_of<Range, double>::value,
+                               bool> = true>
+    void standard_uniform_fill(Range&& out) {
+        with_shard([&](RandomState<RngEngine>& state) { state.standard_uniform_fill(out); });
+    }
+
+    template <typename Range,
+              std::enable_if_t<numpy_random_internel::is_range_of<Range, double>::value,
+                               bool> = true>
+    void standard_normal_fill(Range&& out) {
+        with_shard([&](RandomState<RngEngine>& state) { state.standard_normal_fill(out); });
+    }
+
+    template <typename Range,
+              std::enable_if_t<numpy_random_internel::is_range_of<Range, double>::value,
+                               bool> = true>
+    void standard_exponential_fill(Range&& out) {
+        with_shard([&](RandomState<RngEngine>& state) { state.standard_exponential_fill(out); });
+    }
+
+    template <typename T, typename Range,
+              std::enable_if_t<std::is_floating_point_v<T> &&
+                                   numpy_random_internel::is_range_of<Range, double>::value,
+                               bool> = true>
+    void exponential_fill(T scale, Range&& out) {
+        with_shard([&](RandomState<RngEngine>& state) { state.exponential_fill(scale, out); });
+    }
+
+    template <typename Range,
+              std::enable_if_t<numpy_random_internel::is_range_of<Range, uint64_t>::value,
+                               bool> = true>
+    void uint64_fill(Range&& out) {
+        with_shard([&](RandomState<RngEngine>& state) { state.uint64_fill(out); });
+    }
+
+    template <typename T, typename Range,
+              std::enable_if_t<std::is_floating_point_v<T> &&
+                                   numpy_random_internel::is_range_of<Range, uint8_t>::value,
+                               bool> = true>
+    void bernoulli_fill(T p, Range&& out) {
+        with_shard([&](RandomState<RngEngine>& state) { state.bernoulli_fill(p, out); });
+    }
+
+    /* Runs **fn** like RandomState::with_bitgen on the calling thread's shard. */
+    template <typename Fn>
+    void with_bitgen(Fn&& fn) {
+        with_shard([&](RandomState<RngEngine>& state) { state.with_bitgen(fn); });
+    }
+
+    /* RandomState::stats summed over all shards. */
+    RandomStateStats stats() const {
+        RandomStateStats total{};
+        for (auto& s : _shards) {
+            RandomStateStats part = s.state->stats();
+            for (size_t i = 0; i < RandomStateStats::n_methods; i++) {
+                total.calls[i] += part.calls[i];
+            }
+            total.raw_words += part.raw_words;
+            total.rejection_trials += part.rejection_trials;
+            total.lock_acquisitions += part.lock_acquisitions;
+            total.lock_contentions += part.lock_contentions;
+            total.lock_wait_ns += part.lock_wait_ns;
+        }
+        return total;
+    }
+
+    /* Shards currently in use. */
+    size_t shards() const {
+        return _active.load(std::memory_order_acquire);
+    }
+
+    size_t max_shards() const {
+        return _shards.size();
+    }
+
+    /* Calls that found shard **idx** busy since construction. */
+    uint64_t shard_contentions(size_t idx) const {
+        return _shards[idx].contentions.load(std::memory_order_relaxed);
+    }
+
+    uint64_t contentions() const {
+        uint64_t total = 0;
+        for (auto& s : _shards) {
+            total += s.contentions.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    /* Fibonacci hash of the thread id, computed once per thread. */
+    static size_t thread_hash() {
+        static thread_local size_t hash = (size_t)(
+            (uint64_t)std::hash<std::thread::id>{}(std::this_thread::get_id()) *
+                0x9E3779B97F4A7C15ULL >>
+            32);
+        return hash;
+    }
+
+    template <typename Fn>
+    auto with_shard(Fn&& fn) {
+        auto& s = _shards[thread_hash() % _active.load(std::memory_order_acquire)];
+        if (s.busy.fetch_add(1, std::memory_order_acquire) > 0) {
+            s.contentions.fetch_add(1, std::memory_order_relaxed);
+            if (s.window.fetch_add(1, std::memory_order_relaxed) + 1 >= _threshold) {
+                s.window.store(0, std::memory_order_relaxed);
+                grow();
+            }
+        }
+        /* Decrement on every exit path, fn may return a value. */
+        struct release {
+            std::atomic<uint32_t>& busy;
+            ~release() {
+                busy.fetch_sub(1, std::memory_order_release);
+            }
+        } guard{s.busy};
+        return fn(*s.state);
+    }
+
+    void grow() {
+        size_t active = _active.load(std::memory_order_relaxed);
+        while (active < _shards.size()) {
+            size_t next = active * 2 < _shards.size() ? active * 2 : _shards.size();
+            if (_active.compare_exchange_weak(active, next, std::memory_order_acq_rel)) {
+                return;
+            }
+        }
+    }
+
+private:
+    std::vector<shard> _shards;
+    std::atomic<size_t> _active{1};
+    uint64_t _threshold;
+};
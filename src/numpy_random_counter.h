@@ -0,0 +1,268 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/*
+Counter-based engines (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"). Every output
+block is a pure function of (key, counter), so block i of stream s can be regenerated without
+replaying the stream: put the stream id in the key and call set_counter/advance. Both return a
+4 word container which RandomState consumes through its container path, one word per draw.
+
+`fill` runs several counters side by side in struct-of-arrays form. Threefry is only adds,
+rotates and xors so the lane loops vectorize, Philox needs a 64x64->128 multiply which no common
+SIMD ISA has, there the lanes just give the core independent multiply chains to overlap.
+*/
+namespace numpy_random_internel {
+inline uint64_t mulhilo64(uint64_t a, uint64_t b, uint64_t* hi) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, hi);
+#elif defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    *hi = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+#else
+    uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+    *hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (lo_lo & 0xffffffff);
+#endif
+}
+
+inline uint64_t rotl64(uint64_t x, unsigned int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+/* Adds **n** to a little endian 256 bit counter. */
+inline void counter_add(std::array<uint64_t, 4>& ctr, uint64_t n) {
+    uint64_t carry = (ctr[0] += n) < n;
+    for (size_t i = 1; i < 4 && carry; i++) {
+        carry = (++ctr[i] == 0);
+    }
+}
+
+/* Seed sequences have `generate(first, last)`, which keeps the seeding templates away from the copy
+constructor and the key constructor. */
+template <typename T, typename = void>
+struct is_seed_seq : std::false_type {};
+
+template <typename T>
+struct is_seed_seq<T, std::void_t<decltype(std::declval<T&>().generate(
+                           std::declval<uint32_t*>(), std::declval<uint32_t*>()))>>
+    : std::true_type {};
+
+template <typename SeedSeq, size_t N>
+std::array<uint64_t, N> key_from_seed_seq(SeedSeq& seed_seq) {
+    uint32_t words[N * 2];
+    seed_seq.generate(words, words + N * 2);
+    std::array<uint64_t, N> key{};
+    for (size_t i = 0; i < N; i++) {
+        key[i] = (uint64_t)words[2 * i] << 32 | words[2 * i + 1];
+    }
+    return key;
+}
+
+/*
+Shared engine shell, **Impl** supplies `template <size_t lanes> static void rounds(uint64_t
+(&x)[4][lanes], const key_type& key)` which turns `lanes` counters stored word-major into their
+output blocks in place.
+*/
+template <typename Impl, size_t KeyWords>
+class counter_engine {
+public:
+    using result_type = std::array<uint64_t, 4>;
+    using counter_type = std::array<uint64_t, 4>;
+    using key_type = std::array<uint64_t, KeyWords>;
+
+    /* Blocks computed together by fill. */
+    static constexpr size_t fill_lanes = 8;
+
+    counter_engine() = default;
+
+    /* **seed** goes in the first key word, the rest of the key can hold a stream id. */
+    explicit counter_engine(uint64_t seed) {
+        this->seed(seed);
+    }
+
+    explicit counter_engine(const key_type& key, const counter_type& counter = counter_type{})
+        : _key(key), _counter(counter) {}
+
+    template <typename SeedSeq, std::enable_if_t<is_seed_seq<SeedSeq>::value, bool> = true>
+    explicit counter_engine(SeedSeq& seed_seq) {
+        seed(seed_seq);
+    }
+
+    void seed(uint64_t seed) {
+        _key = key_type{};
+        _key[0] = seed;
+        _counter = counter_type{};
+    }
+
+    template <typename SeedSeq, std::enable_if_t<is_seed_seq<SeedSeq>::value, bool> = true>
+    void seed(SeedSeq& seed_seq) {
+        _key = key_from_seed_seq<SeedSeq, KeyWords>(seed_seq);
+        _counter = counter_type{};
+    }
+
+    void set_key(const key_type& key) {
+        _key = key;
+    }
+
+    const key_type& key() const {
+        return _key;
+    }
+
+    /* The next operator() returns block(**counter**). */
+    void set_counter(const counter_type& counter) {
+        _counter = counter;
+    }
+
+    const counter_type& counter() const {
+        return _counter;
+    }
+
+    /* Skips **n_blocks** blocks, 4 words each, in O(1). */
+    void advance(uint64_t n_blocks) {
+        counter_add(_counter, n_blocks);
+    }
+
+    void discard(unsigned long long n_blocks) {
+        advance((uint64_t)n_blocks);
+    }
+
+    /* Output block for **counter** under the current key, does not touch the engine counter. */
+    result_type block(const counter_type& counter) const {
+        uint64_t x[4][1];
+        for (size_t w = 0; w < 4; w++) {
+            x[w][0] = counter[w];
+        }
+        Impl::template rounds<1>(x, _key);
+        return result_type{x[0][0], x[1][0], x[2][0], x[3][0]};
+    }
+
+    result_type operator()() {
+        result_type out = block(_counter);
+        counter_add(_counter, 1);
+        return out;
+    }
+
+    /* Writes the next **n_blocks** blocks, 4 * n_blocks words, exactly as n_blocks calls to
+    operator() would. */
+    void fill(uint64_t* out, size_t n_blocks) {
+        size_t i = 0;
+        for (; i + fill_lanes <= n_blocks; i += fill_lanes) {
+            uint64_t x[4][fill_lanes];
+            counter_type ctr = _counter;
+            for (size_t l = 0; l < fill_lanes; l++) {
+                for (size_t w = 0; w < 4; w++) {
+                    x[w][l] = ctr[w];
+                }
+                counter_add(ctr, 1);
+            }
+            Impl::template rounds<fill_lanes>(x, _key);
+            for (size_t l = 0; l < fill_lanes; l++) {
+                for (size_t w = 0; w < 4; w++) {
+                    out[4 * (i + l) + w] = x[w][l];
+                }
+            }
+            _counter = ctr;
+        }
+        for (; i < n_blocks; i++) {
+            result_type blk = (*this)();
+            for (size_t w = 0; w < 4; w++) {
+                out[4 * i + w] = blk[w];
+            }
+        }
+    }
+
+private:
+    key_type _key{};
+    counter_type _counter{};
+};
+
+struct philox4x64_rounds {
+    static constexpr uint64_t M0 = 0xD2E7470EE14C6C93ULL;
+    static constexpr uint64_t M1 = 0xCA5A826395121157ULL;
+    static constexpr uint64_t W0 = 0x9E3779B97F4A7C15ULL;
+    static constexpr uint64_t W1 = 0xBB67AE8584CAA73BULL;
+
+    template <size_t lanes>
+    static void rounds(uint64_t (&x)[4][lanes], const std::array<uint64_t, 2>& key) {
+        uint64_t k0 = key[0], k1 = key[1];
+        for (int r = 0; r < 10; r++) {
+            for (size_t l = 0; l < lanes; l++) {
+                uint64_t hi0, hi1;
+                uint64_t lo0 = mulhilo64(M0, x[0][l], &hi0);
+                uint64_t lo1 = mulhilo64(M1, x[2][l], &hi1);
+                x[0][l] = hi1 ^ x[1][l] ^ k0;
+                x[1][l] = lo1;
+                x[2][l] = hi0 ^ x[3][l] ^ k1;
+                x[3][l] = lo0;
+            }
+            k0 += W0;
+            k1 += W1;
+        }
+    }
+};
+
+struct threefry4x64_rounds {
+    static constexpr uint64_t KS_PARITY = 0x1BD11BDAA9FC1A22ULL;
+    static constexpr unsigned int R[8][2] = {{14, 16}, {52, 57}, {23, 40}, {5, 37},
+                                             {25, 33}, {46, 12}, {58, 22}, {32, 32}};
+
+    template <size_t lanes>
+    static void rounds(uint64_t (&x)[4][lanes], const std::array<uint64_t, 4>& key) {
+        uint64_t ks[5] = {key[0], key[1], key[2], key[3],
+                          KS_PARITY ^ key[0] ^ key[1] ^ key[2] ^ key[3]};
+
+        inject(x, ks, 0);
+        for (unsigned int r = 0; r < 20; r++) {
+            unsigned int r0 = R[r % 8][0], r1 = R[r % 8][1];
+            if (r % 2 == 0) {
+                for (size_t l = 0; l < lanes; l++) {
+                    x[0][l] += x[1][l];
+                    x[1][l] = rotl64(x[1][l], r0) ^ x[0][l];
+                    x[2][l] += x[3][l];
+                    x[3][l] = rotl64(x[3][l], r1) ^ x[2][l];
+                }
+            }
+            else {
+                for (size_t l = 0; l < lanes; l++) {
+                    x[0][l] += x[3][l];
+                    x[3][l] = rotl64(x[3][l], r0) ^ x[0][l];
+                    x[2][l] += x[1][l];
+                    x[1][l] = rotl64(x[1][l], r1) ^ x[2][l];
+                }
+            }
+            if (r % 4 == 3) {
+                inject(x, ks, r / 4 + 1);
+            }
+        }
+    }
+
+    template <size_t lanes>
+    static void inject(uint64_t (&x)[4][lanes], const uint64_t (&ks)[5], unsigned int s) {
+        for (size_t l = 0; l < lanes; l++) {
+            x[0][l] += ks[s % 5];
+            x[1][l] += ks[(s + 1) % 5];
+            x[2][l] += ks[(s + 2) % 5];
+            x[3][l] += ks[(s + 3) % 5] + s;
+        }
+    }
+};
+} // namespace numpy_random_internel
+
+/* Philox4x64-10, 128 bit key. */
+using Philox4x64 =
+    numpy_random_internel::counter_engine<numpy_random_internel::philox4x64_rounds, 2>;
+
+/* Threefry4x64-20, 256 bit key. */
+using Threefry4x64 =
+    numpy_random_internel::counter_engine<numpy_random_internel::threefry4x64_rounds, 4>;
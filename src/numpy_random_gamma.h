@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include "numpy_random.h"
+
+extern "C" {
+#include "numpy/random/bitgen.h"
+#include "numpy/random/distributions.h"
+#include "numpy/random/legacy/legacy-distributions.h"
+}
+
+/*
+Gamma(shape, scale) draws for a fixed shape. The Marsaglia-Tsang constants b = shape - 1/3 and
+c = 1 / sqrt(9b), and 1 / shape for shape < 1, are computed once by the constructor instead of on
+every draw.
+
+stream::legacy draws the values of numpy's `RandomState.gamma` (polar gauss), the same stream as
+RandomState::gamma. stream::ziggurat draws those of numpy's `Generator.gamma` (ziggurat normals),
+whose fill for shape > 1 batches the accept test over a chunk of draws. Either way a fill gives
+exactly the values of cnt single draws.
+*/
+class GammaSampler {
+public:
+    enum class stream { legacy, ziggurat };
+
+    explicit GammaSampler(double shape, double scale = 1.0, stream kind = stream::legacy)
+        : _scale(scale), _kind(kind) {
+        random_gamma_prepare(&_gamma, shape);
+    }
+
+    double shape() const {
+        return _gamma.shape;
+    }
+
+    double scale() const {
+        return _scale;
+    }
+
+    stream kind() const {
+        return _kind;
+    }
+
+    template <typename RngEngine>
+    double operator()(RandomState<RngEngine>& random) const {
+        double value = 0.0;
+        random.with_bitgen([&](bitgen_t* bitgen_state, aug_bitgen_t* aug_state, binomial_t*) {
+            value = (*this)(bitgen_state, aug_state);
+        });
+        return value;
+    }
+
+    /* **cnt** draws under one lock of **random**. */
+    template <typename RngEngine>
+    void fill(RandomState<RngEngine>& random, double* out, size_t cnt) const {
+        random.with_bitgen([&](bitgen_t* bitgen_state, aug_bitgen_t* aug_state, binomial_t*) {
+            fill(bitgen_state, aug_state, out, cnt);
+        });
+    }
+
+    /* On a C state directly, eg. inside MultiStream::with_lane or RandomStatePool::with_agent. */
+    double operator()(bitgen_t* bitgen_state, aug_bitgen_t* aug_state) const {
+        if (_kind == stream::legacy) {
+            return _scale * legacy_standard_gamma_prepared(aug_state, &_gamma);
+        }
+        return _scale * random_standard_gamma_prepared(bitgen_state, &_gamma);
+    }
+
+    void fill(bitgen_t* bitgen_state, aug_bitgen_t* aug_state, double* out, size_t cnt) const {
+        if (_kind == stream::legacy) {
+            legacy_standard_gamma_fill(aug_state, &_gamma, (npy_intp)cnt, out);
+        }
+        else {
+            random_standard_gamma_fill(bitgen_state, &_gamma, (npy_intp)cnt, out);
+        }
+        if (_scale != 1.0) {
+            for (size_t i = 0; i < cnt; i++) {
+                out[i] = _scale * out[i];
+            }
+        }
+    }
+
+private:
+    gamma_t _gamma;
+    double _scale;
+    stream _kind;
+};
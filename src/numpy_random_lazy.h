@@ -0,0 +1,145 @@
+#pragma once
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include "numpy_random.h"
+#include "numpy_random_parallel.h"
+
+/*
+A random array of **size** elements that only exists where it is read. Element i lives in block
+i / block_size and a block is drawn on first access from block_substream(key, block), exactly like
+parallel_fill draws it, so element i is the same value whatever the access order and equals
+element i of a parallel_fill over the whole array with the same key and block size.
+
+At most **max_blocks** blocks are kept, the least recently used one is dropped when a new block is
+needed, so memory follows the working set instead of the logical size. Thread-safe, reads take a
+lock like RandomState.
+*/
+template <typename Dist, typename T = double, typename Engine = Philox4x64>
+class LazyRandomArray {
+public:
+    LazyRandomArray(const Dist& dist, size_t size, const typename Engine::key_type& key,
+                    size_t block_size = 65536, size_t max_blocks = 64)
+        : _dist(dist), _size(size), _key(key), _block_size(block_size > 0 ? block_size : 1),
+          _max_blocks(max_blocks > 0 ? max_blocks : 1) {}
+
+    LazyRandomArray(const LazyRandomArray&) = delete;
+    LazyRandomArray& operator=(const LazyRandomArray&) = delete;
+
+    size_t size() const {
+        return _size;
+    }
+
+    size_t block_size() const {
+        return _block_size;
+    }
+
+    /* Element **idx**, 0 past the end. */
+    T operator[](size_t idx) {
+        if (idx >= _size) {
+            return (T)0;
+        }
+        std::lock_guard lock{_mutex};
+        return fetch(idx / _block_size)[idx % _block_size];
+    }
+
+    /* Copies elements [first, first + cnt) to **out**, clipped to the array. */
+    void read(size_t first, size_t cnt, T* out) {
+        if (first >= _size) {
+            return;
+        }
+        if (cnt > _size - first) {
+            cnt = _size - first;
+        }
+        std::lock_guard lock{_mutex};
+        while (cnt > 0) {
+            size_t offset = first % _block_size;
+            size_t n = _block_size - offset < cnt ? _block_size - offset : cnt;
+            const T* values = fetch(first / _block_size);
+            for (size_t i = 0; i < n; i++) {
+                out[i] = values[offset + i];
+            }
+            out += n;
+            first += n;
+            cnt -= n;
+        }
+    }
+
+    /* Blocks currently cached. */
+    size_t resident_blocks() const {
+        std::lock_guard lock{_mutex};
+        return _blocks.size();
+    }
+
+    /* Reads served from the cache and reads that had to draw their block. */
+    uint64_t hits() const {
+        std::lock_guard lock{_mutex};
+        return _hits;
+    }
+
+    uint64_t misses() const {
+        std::lock_guard lock{_mutex};
+        return _misses;
+    }
+
+    /* Drops every cached block, the values come back identical on the next read. */
+    void clear() {
+        std::lock_guard lock{_mutex};
+        _blocks.clear();
+        _lru.clear();
+    }
+
+private:
+    struct cached_block {
+        std::unique_ptr<T[]> values;
+        typename std::list<uint64_t>::iterator lru;
+    };
+
+    const T* fetch(uint64_t block) {
+        auto found = _blocks.find(block);
+        if (found != _blocks.end()) {
+            _hits++;
+            _lru.splice(_lru.begin(), _lru, found->second.lru);
+            return found->second.values.get();
+        }
+        _misses++;
+
+        std::unique_ptr<T[]> values;
+        if (_blocks.size() >= _max_blocks) {
+            uint64_t victim = _lru.back();
+            _lru.pop_back();
+            auto evicted = _blocks.find(victim);
+            values = std::move(evicted->second.values);
+            _blocks.erase(evicted);
+        }
+        else {
+            values.reset(new T[_block_size]);
+        }
+
+        size_t first = (size_t)block * _block_size;
+        size_t n = _size - first < _block_size ? _size - first : _block_size;
+        RandomState<Engine> state(block_substream<Engine>(_key, block));
+        _dist(state, values.get(), n);
+
+        _lru.push_front(block);
+        auto& slot = _blocks[block];
+        slot.values = std::move(values);
+        slot.lru = _lru.begin();
+        return slot.values.get();
+    }
+
+private:
+    Dist _dist;
+    size_t _size;
+    typename Engine::key_type _key;
+    size_t _block_size;
+    size_t _max_blocks;
+
+    mutable std::mutex _mutex{};
+    std::unordered_map<uint64_t, cached_block> _blocks{};
+    std::list<uint64_t> _lru{};
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+};
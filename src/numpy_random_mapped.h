@@ -0,0 +1,349 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+Pre-generated random pools. A pool file is a MappedPoolHeader followed by `count` values of
+`value_size` bytes in native byte order, either raw engine words or the output of a distribution.
+The header records how the values were made so a run can check it replays what it expects.
+*/
+struct MappedPoolHeader {
+    static constexpr char MAGIC[8] = {'N', 'P', 'R', 'P', 'O', 'O', 'L', '\0'};
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t seed;
+    /* Values after the header. */
+    uint64_t count;
+    uint32_t value_size;
+    uint32_t reserved;
+    /* Engine name and "raw" or the distribution name, NUL padded. */
+    char engine[24];
+    char distribution[24];
+    double params[4];
+    uint64_t reserved2;
+
+    static MappedPoolHeader make(const char* engine_name, const char* distribution_name,
+                                 uint64_t seed, uint32_t value_size) {
+        MappedPoolHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.header_size = (uint32_t)sizeof(MappedPoolHeader);
+        header.seed = seed;
+        header.value_size = value_size;
+        std::strncpy(header.engine, engine_name, sizeof(header.engine) - 1);
+        std::strncpy(header.distribution, distribution_name, sizeof(header.distribution) - 1);
+        return header;
+    }
+
+    bool valid() const {
+        return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 && version == VERSION &&
+               header_size == sizeof(MappedPoolHeader) && value_size > 0;
+    }
+};
+
+static_assert(sizeof(MappedPoolHeader) == 128, "MappedPoolHeader is part of the file format.");
+
+/* Streams values into a pool file, the count in the header is filled in by close(). */
+class MappedPoolWriter {
+public:
+    MappedPoolWriter() = default;
+
+    MappedPoolWriter(const char* path, const MappedPoolHeader& header) {
+        open(path, header);
+    }
+
+    MappedPoolWriter(const MappedPoolWriter&) = delete;
+    MappedPoolWriter& operator=(const MappedPoolWriter&) = delete;
+
+    ~MappedPoolWriter() {
+        close();
+    }
+
+    bool open(const char* path, const MappedPoolHeader& header) {
+        close();
+        _file = std::fopen(path, "wb");
+        if (_file == nullptr) {
+            return false;
+        }
+        _header = header;
+        _header.count = 0;
+        return std::fwrite(&_header, sizeof(_header), 1, _file) == 1;
+    }
+
+    bool is_open() const {
+        return _file != nullptr;
+    }
+
+    /* **cnt** values of the header's value_size. */
+    bool write(const void* values, size_t cnt) {
+        if (_file == nullptr) {
+            return false;
+        }
+        size_t written = std::fwrite(values, _header.value_size, cnt, _file);
+        _header.count += written;
+        return written == cnt;
+    }
+
+    bool close() {
+        if (_file == nullptr) {
+            return false;
+        }
+        bool ok = std::fseek(_file, 0, SEEK_SET) == 0 &&
+                  std::fwrite(&_header, sizeof(_header), 1, _file) == 1;
+        ok = std::fclose(_file) == 0 && ok;
+        _file = nullptr;
+        return ok;
+    }
+
+private:
+    std::FILE* _file = nullptr;
+    MappedPoolHeader _header{};
+};
+
+/*
+RngEngine over a memory-mapped pool file of raw 64 bit words. operator() hands out a view of the
+next **words_per_call** words straight from the mapping, so `RandomState<MappedRandomSource>` takes
+them through its container path and replays the stream of the engine that was dumped, without
+running it. Pools of distribution output are read through values<T>() instead.
+
+When the file runs out it starts over from the first word and wraps() counts how often, a replay
+that wraps is no longer drawing fresh values.
+*/
+class MappedRandomSource {
+public:
+    struct view {
+        const uint64_t* words;
+        size_t cnt;
+
+        const uint64_t& operator[](size_t idx) const {
+            return words[idx];
+        }
+
+        size_t size() const {
+            return cnt;
+        }
+    };
+
+    using result_type = view;
+
+    MappedRandomSource() = default;
+
+    explicit MappedRandomSource(const char* path, size_t words_per_call = 64) {
+        open(path, words_per_call);
+    }
+
+    MappedRandomSource(const MappedRandomSource&) = delete;
+    MappedRandomSource& operator=(const MappedRandomSource&) = delete;
+
+    MappedRandomSource(MappedRandomSource&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedRandomSource& operator=(MappedRandomSource&& other) noexcept {
+        if (this != &other) {
+            close();
+            _mapping = std::exchange(other._mapping, nullptr);
+            _mapping_size = std::exchange(other._mapping_size, 0);
+#ifdef _WIN32
+            _file = std::exchange(other._file, INVALID_HANDLE_VALUE);
+            _map = std::exchange(other._map, nullptr);
+#endif
+            _header = std::exchange(other._header, nullptr);
+            _words = std::exchange(other._words, nullptr);
+            _size = std::exchange(other._size, 0);
+            _pos = std::exchange(other._pos, 0);
+            _wraps = std::exchange(other._wraps, 0);
+            _words_per_call = other._words_per_call;
+        }
+        return *this;
+    }
+
+    ~MappedRandomSource() {
+        close();
+    }
+
+    /* Maps **path** read-only, false if it can not be mapped, is not a pool file or is empty. */
+    bool open(const char* path, size_t words_per_call = 64) {
+        close();
+        _words_per_call = words_per_call > 0 ? words_per_call : 1;
+        if (!map(path)) {
+            return false;
+        }
+
+        auto header = (const MappedPoolHeader*)_mapping;
+        if (_mapping_size < sizeof(MappedPoolHeader) || !header->valid()) {
+            close();
+            return false;
+        }
+        /* Divided rather than count * value_size, which a crafted header can overflow. An empty
+        pool is refused, operator() would hand out empty views forever. */
+        uint64_t capacity = (_mapping_size - sizeof(MappedPoolHeader)) / header->value_size;
+        if (header->count == 0 || header->count > capacity) {
+            close();
+            return false;
+        }
+        _header = header;
+        _words = (const uint64_t*)((const unsigned char*)_mapping + sizeof(MappedPoolHeader));
+        _size = (size_t)(header->count * header->value_size / sizeof(uint64_t));
+        return true;
+    }
+
+    void close() {
+        if (_mapping != nullptr) {
+#ifdef _WIN32
+            UnmapViewOfFile(_mapping);
+            CloseHandle(_map);
+            CloseHandle(_file);
+            _file = INVALID_HANDLE_VALUE;
+            _map = nullptr;
+#else
+            munmap(_mapping, _mapping_size);
+#endif
+        }
+        _mapping = nullptr;
+        _mapping_size = 0;
+        _header = nullptr;
+        _words = nullptr;
+        _size = 0;
+        _pos = 0;
+        _wraps = 0;
+    }
+
+    bool is_open() const {
+        return _header != nullptr;
+    }
+
+    /* nullptr when nothing is mapped. */
+    const MappedPoolHeader* header() const {
+        return _header;
+    }
+
+    const uint64_t* words() const {
+        return _words;
+    }
+
+    /* Whole 64 bit words in the pool. */
+    size_t size() const {
+        return _size;
+    }
+
+    /* The pool as values of **T**, eg. doubles of a dumped normal distribution. */
+    template <typename T>
+    const T* values() const {
+        return (const T*)_words;
+    }
+
+    size_t value_count() const {
+        return _header != nullptr ? (size_t)_header->count : 0;
+    }
+
+    /* The next operator() starts at word **word**. */
+    void seek(size_t word) {
+        _pos = _size > 0 ? word % _size : 0;
+    }
+
+    size_t tell() const {
+        return _pos;
+    }
+
+    uint64_t wraps() const {
+        return _wraps;
+    }
+
+    /* Next words_per_call words, fewer at the end of the file, none when nothing is mapped. */
+    view operator()() {
+        if (_size == 0) {
+            return view{nullptr, 0};
+        }
+        if (_pos >= _size) {
+            _pos = 0;
+            _wraps++;
+        }
+        size_t cnt = _size - _pos < _words_per_call ? _size - _pos : _words_per_call;
+        view out{_words + _pos, cnt};
+        _pos += cnt;
+        return out;
+    }
+
+private:
+    bool map(const char* path) {
+#ifdef _WIN32
+        _file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (_file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER file_size{};
+        if (!GetFileSizeEx(_file, &file_size) || file_size.QuadPart == 0) {
+            CloseHandle(_file);
+            _file = INVALID_HANDLE_VALUE;
+            return false;
+        }
+        _map = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_map == nullptr) {
+            CloseHandle(_file);
+            _file = INVALID_HANDLE_VALUE;
+            return false;
+        }
+        _mapping = MapViewOfFile(_map, FILE_MAP_READ, 0, 0, 0);
+        if (_mapping == nullptr) {
+            CloseHandle(_map);
+            CloseHandle(_file);
+            _map = nullptr;
+            _file = INVALID_HANDLE_VALUE;
+            return false;
+        }
+        _mapping_size = (size_t)file_size.QuadPart;
+        return true;
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* mapping = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        /* Replays read front to back. */
+        madvise(mapping, (size_t)st.st_size, MADV_SEQUENTIAL);
+        _mapping = mapping;
+        _mapping_size = (size_t)st.st_size;
+        return true;
+#endif
+    }
+
+private:
+    void* _mapping = nullptr;
+    size_t _mapping_size = 0;
+#ifdef _WIN32
+    HANDLE _file = INVALID_HANDLE_VALUE;
+    HANDLE _map = nullptr;
+#endif
+
+    const MappedPoolHeader* _header = nullptr;
+    const uint64_t* _words = nullptr;
+    size_t _size = 0;
+    size_t _pos = 0;
+    uint64_t _wraps = 0;
+    size_t _words_per_call = 64;
+};
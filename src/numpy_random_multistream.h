@@ -0,0 +1,247 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include "numpy_random.h"
+#include "numpy_random_counter.h"
+
+extern "C" {
+#include "numpy/random/bitgen.h"
+#include "numpy/random/distributions.h"
+#include "numpy/random/legacy/legacy-distributions.h"
+}
+
+/*
+N independent streams of a counter-based engine advanced together. The lanes share the key and
+lane l starts at counter {0, 0, l, 0}, so their counters never meet and every refill is one
+`rounds<N>` call over N counters in struct-of-arrays form, the same lane loop `fill` vectorizes.
+
+Each lane buffers its words and has its own bitgen_t/aug_bitgen_t, so the C kernels run on it
+unchanged. Lane l draws exactly what a `RandomState<Engine>` whose engine has the same key and
+counter {0, 0, l, 0} draws. The batched calls write one value per lane to out[0..N). Not
+thread-safe, use one MultiStream per thread.
+*/
+template <typename Engine, size_t N = 8>
+class MultiStream {
+    static_assert(sizeof(Engine) == 0,
+                  "MultiStream is only implemented for the counter-based engines, eg. Philox4x64.");
+};
+
+template <typename Impl, size_t KeyWords, size_t N>
+class MultiStream<numpy_random_internel::counter_engine<Impl, KeyWords>, N> {
+    using engine_type = numpy_random_internel::counter_engine<Impl, KeyWords>;
+
+    static_assert(N > 0, "MultiStream needs at least one lane.");
+
+    /* One block is 4 words, a lane is topped up whenever it holds a block or less. */
+    static constexpr size_t BLOCK_WORDS = 4;
+    static constexpr size_t BUFFER_WORDS = 2 * BLOCK_WORDS;
+
+public:
+    using key_type = typename engine_type::key_type;
+    using counter_type = typename engine_type::counter_type;
+
+    static constexpr size_t lanes = N;
+
+    explicit MultiStream(const key_type& key) : _key(key) {
+        init();
+    }
+
+    /* **seed** goes in the first key word like `Philox4x64(seed)`. */
+    explicit MultiStream(uint64_t seed) : _key{} {
+        _key[0] = seed;
+        init();
+    }
+
+    template <typename SeedSeq, std::enable_if_t<!std::is_arithmetic_v<SeedSeq> &&
+                                                     !std::is_same_v<SeedSeq, key_type>,
+                                                 bool> = true>
+    explicit MultiStream(SeedSeq& seed_seq)
+        : _key(numpy_random_internel::key_from_seed_seq<SeedSeq, KeyWords>(seed_seq)) {
+        init();
+    }
+
+    /* The lane callbacks point back into this object. */
+    MultiStream(const MultiStream&) = delete;
+    MultiStream& operator=(const MultiStream&) = delete;
+
+    const key_type& key() const {
+        return _key;
+    }
+
+    /* Counter of the next block lane **lane** will compute, its buffered words come first. */
+    counter_type counter(size_t lane) const {
+        return counter_type{_counter[0][lane], _counter[1][lane], _counter[2][lane],
+                            _counter[3][lane]};
+    }
+
+    void raw(uint64_t* out) {
+        refill();
+        for (size_t l = 0; l < N; l++) {
+            out[l] = next_raw(&_refs[l]);
+        }
+    }
+
+    void standard_uniform(double* out) {
+        refill();
+        for (size_t l = 0; l < N; l++) {
+            out[l] = next_double(&_refs[l]);
+        }
+    }
+
+    void uniform(double low, double high, double* out) {
+        refill();
+        for (size_t l = 0; l < N; l++) {
+            out[l] = random_uniform(&_bitgen[l], low, high - low);
+        }
+    }
+
+    /* Legacy polar gauss, every lane keeps its own cached second value like RandomState::rand_n. */
+    void rand_n(double* out) {
+        refill();
+        for (size_t l = 0; l < N; l++) {
+            out[l] = legacy_gauss(&_aug_state[l]);
+        }
+    }
+
+    /* Ziggurat normals, faster than rand_n but not the legacy stream. */
+    void standard_normal(double* out) {
+        refill();
+        for (size_t l = 0; l < N; l++) {
+            out[l] = random_standard_normal(&_bitgen[l]);
+        }
+    }
+
+    /* Runs **fn(bitgen_t*, aug_bitgen_t*)** on lane **lane**, for any other kernel. */
+    template <typename Fn>
+    void with_lane(size_t lane, Fn&& fn) {
+        fn(&_bitgen[lane], &_aug_state[lane]);
+    }
+
+private:
+    struct lane_ref {
+        MultiStream* self;
+        size_t lane;
+    };
+
+    void init() {
+        for (size_t l = 0; l < N; l++) {
+            _counter[0][l] = 0;
+            _counter[1][l] = 0;
+            _counter[2][l] = (uint64_t)l;
+            _counter[3][l] = 0;
+            _words_cnt[l] = 0;
+            _words_pos[l] = 0;
+            _has_integer[l] = 0;
+            _uinteger[l] = 0;
+
+            _refs[l] = lane_ref{this, l};
+            _bitgen[l] = bitgen_t{};
+            _bitgen[l].state = &_refs[l];
+            _bitgen[l].next_uint64 = &next_uint64;
+            _bitgen[l].next_uint32 = &next_uint32;
+            _bitgen[l].next_double = &next_double;
+            _bitgen[l].next_raw = &next_raw;
+
+            _aug_state[l] = aug_bitgen_t{};
+            _aug_state[l].bit_generator = &_bitgen[l];
+        }
+    }
+
+    /* Computes the next block of every lane in one pass and appends it to the lanes running low,
+    the other lanes keep their counter so nothing is skipped. */
+    void refill() {
+        uint64_t x[4][N];
+        for (size_t w = 0; w < 4; w++) {
+            for (size_t l = 0; l < N; l++) {
+                x[w][l] = _counter[w][l];
+            }
+        }
+        Impl::template rounds<N>(x, _key);
+
+        for (size_t l = 0; l < N; l++) {
+            if (_words_cnt[l] > BUFFER_WORDS - BLOCK_WORDS) {
+                continue;
+            }
+            push_block(l, x[0][l], x[1][l], x[2][l], x[3][l]);
+        }
+    }
+
+    /* A lane that ran dry inside a rejection loop computes its next block alone. */
+    void refill_lane(size_t lane) {
+        uint64_t x[4][1];
+        for (size_t w = 0; w < 4; w++) {
+            x[w][0] = _counter[w][lane];
+        }
+        Impl::template rounds<1>(x, _key);
+        push_block(lane, x[0][0], x[1][0], x[2][0], x[3][0]);
+    }
+
+    void push_block(size_t lane, uint64_t w0, uint64_t w1, uint64_t w2, uint64_t w3) {
+        uint64_t* words = _words[lane];
+        size_t cnt = _words_cnt[lane];
+        size_t pos = _words_pos[lane];
+        for (size_t i = 0; i < cnt; i++) {
+            words[i] = words[pos + i];
+        }
+        words[cnt] = w0;
+        words[cnt + 1] = w1;
+        words[cnt + 2] = w2;
+        words[cnt + 3] = w3;
+        _words_pos[lane] = 0;
+        _words_cnt[lane] = cnt + BLOCK_WORDS;
+
+        /* Same carry as counter_add, on the lane's column. */
+        uint64_t carry = (++_counter[0][lane] == 0);
+        for (size_t w = 1; w < 4 && carry; w++) {
+            carry = (++_counter[w][lane] == 0);
+        }
+    }
+
+    static uint64_t next_raw(void* ptr) {
+        auto& ref = *(lane_ref*)ptr;
+        auto& self = *ref.self;
+        size_t l = ref.lane;
+        if (self._words_cnt[l] == 0) {
+            self.refill_lane(l);
+        }
+        self._words_cnt[l]--;
+        return self._words[l][self._words_pos[l]++];
+    }
+
+    static uint64_t next_uint64(void* ptr) {
+        return next_raw(ptr);
+    }
+
+    static uint32_t next_uint32(void* ptr) {
+        auto& ref = *(lane_ref*)ptr;
+        auto& self = *ref.self;
+        size_t l = ref.lane;
+        if (self._has_integer[l]) {
+            self._has_integer[l] = 0;
+            return self._uinteger[l];
+        }
+        uint64_t next = next_raw(ptr);
+        self._has_integer[l] = 1;
+        self._uinteger[l] = (uint32_t)(next >> 32);
+        return (uint32_t)(next & 0xffffffff);
+    }
+
+    static double next_double(void* ptr) {
+        uint64_t rnd = next_raw(ptr);
+        return (double)((rnd >> 11) * (1.0 / 9007199254740992.0));
+    }
+
+private:
+    key_type _key;
+    alignas(64) uint64_t _counter[4][N];
+    uint64_t _words[N][BUFFER_WORDS];
+    uint8_t _words_cnt[N];
+    uint8_t _words_pos[N];
+    uint8_t _has_integer[N];
+    uint32_t _uinteger[N];
+
+    lane_ref _refs[N];
+    bitgen_t _bitgen[N];
+    aug_bitgen_t _aug_state[N];
+};
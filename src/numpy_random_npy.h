@@ -0,0 +1,315 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/*
+.npy format version 1.0 (numpy/lib/format.py): the magic, a little endian uint16 header length and
+a Python dict literal padded with spaces and a newline, then the raw C order data.
+*/
+namespace numpy_random_internel {
+inline bool little_endian() {
+    uint16_t one = 1;
+    unsigned char first = 0;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+} // namespace numpy_random_internel
+
+/* NumPy dtype string of **T** in native byte order, eg. "<f8" for double. */
+template <typename T>
+std::string npy_descr() {
+    static_assert(std::is_arithmetic_v<T>, "npy_descr only knows the arithmetic types.");
+    if constexpr (sizeof(T) == 1) {
+        return std::is_same_v<T, bool> ? "|b1" : (std::is_signed_v<T> ? "|i1" : "|u1");
+    }
+    else {
+        char kind = std::is_floating_point_v<T> ? 'f' : (std::is_signed_v<T> ? 'i' : 'u');
+        char order = numpy_random_internel::little_endian() ? '<' : '>';
+        return std::string{order, kind} + std::to_string(sizeof(T));
+    }
+}
+
+/*
+Header of a C order array of **descr** with **shape**, padded so the data starts at a multiple of
+**align** bytes. NumPy wants 64, use the page size to memory map or O_DIRECT the data. Empty when
+the header does not fit the 16 bit length of version 1.0.
+*/
+inline std::string npy_header(const std::string& descr, const std::vector<size_t>& shape,
+                              size_t align = 64) {
+    std::string dict = "{'descr': '" + descr + "', 'fortran_order': False, 'shape': (";
+    for (size_t i = 0; i < shape.size(); i++) {
+        dict += std::to_string(shape[i]);
+        if (i + 1 < shape.size() || shape.size() == 1) {
+            dict += ",";
+        }
+        if (i + 1 < shape.size()) {
+            dict += " ";
+        }
+    }
+    dict += "), }";
+
+    constexpr size_t PREFIX = 10;
+    if (align < 64) {
+        align = 64;
+    }
+    size_t total = (PREFIX + dict.size() + 1 + align - 1) / align * align;
+    size_t header_len = total - PREFIX;
+    if (header_len > 0xffff) {
+        return std::string{};
+    }
+    dict.append(header_len - dict.size() - 1, ' ');
+    dict += '\n';
+
+    std::string header = "\x93NUMPY";
+    header += (char)1;
+    header += (char)0;
+    header += (char)(header_len & 0xff);
+    header += (char)(header_len >> 8);
+    return header + dict;
+}
+
+/*
+A .npy image, header and data in one page aligned block, either in memory or a file mapped
+read-write. The data starts on a page boundary so the fill methods write straight into data() and
+the bytes are already what `numpy.load` reads, file-backed arrays can be opened with
+`np.load(path, mmap_mode='r')` without a copy on either side.
+*/
+template <typename T>
+class NpyArray {
+public:
+    static constexpr size_t PAGE = 4096;
+
+    NpyArray() = default;
+
+    /* In memory, save() or bytes() hand it on. */
+    explicit NpyArray(const std::vector<size_t>& shape) {
+        if (!layout(shape)) {
+            close();
+            return;
+        }
+        _image = (unsigned char*)::operator new(_image_size, std::align_val_t{PAGE});
+        finish_open();
+    }
+
+    /* Backed by **path**, created or truncated to the image size and mapped shared. */
+    NpyArray(const char* path, const std::vector<size_t>& shape) {
+        if (!layout(shape) || !map(path)) {
+            close();
+            return;
+        }
+        _mapped = true;
+        finish_open();
+    }
+
+    NpyArray(const NpyArray&) = delete;
+    NpyArray& operator=(const NpyArray&) = delete;
+
+    NpyArray(NpyArray&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    NpyArray& operator=(NpyArray&& other) noexcept {
+        if (this != &other) {
+            close();
+            _shape = std::move(other._shape);
+            _size = std::exchange(other._size, 0);
+            _header_size = std::exchange(other._header_size, 0);
+            _image_size = std::exchange(other._image_size, 0);
+            _image = std::exchange(other._image, nullptr);
+            _mapped = std::exchange(other._mapped, false);
+#ifdef _WIN32
+            _file = std::exchange(other._file, INVALID_HANDLE_VALUE);
+            _map = std::exchange(other._map, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    ~NpyArray() {
+        close();
+    }
+
+    bool is_open() const {
+        return _image != nullptr;
+    }
+
+    T* data() {
+        return _image != nullptr ? (T*)(_image + _header_size) : nullptr;
+    }
+
+    const T* data() const {
+        return _image != nullptr ? (const T*)(_image + _header_size) : nullptr;
+    }
+
+    /* Elements, the product of the shape, 0 when the array failed to open. */
+    size_t size() const {
+        return _size;
+    }
+
+    /* The data as a range, so the range overloads of the RandomState fills take the array. */
+    T* begin() {
+        return data();
+    }
+
+    T* end() {
+        return data() + _size;
+    }
+
+    const T* begin() const {
+        return data();
+    }
+
+    const T* end() const {
+        return data() + _size;
+    }
+
+    const std::vector<size_t>& shape() const {
+        return _shape;
+    }
+
+    /* The whole .npy file image. */
+    const void* bytes() const {
+        return _image;
+    }
+
+    size_t byte_size() const {
+        return _image_size;
+    }
+
+    /* Writes the image to **path**, for in memory arrays. */
+    bool save(const char* path) const {
+        if (_image == nullptr) {
+            return false;
+        }
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        bool ok = std::fwrite(_image, 1, _image_size, file) == _image_size;
+        return std::fclose(file) == 0 && ok;
+    }
+
+    /* Pushes a file-backed array to disk, readers of the file see the data without it. */
+    bool flush() {
+        if (!_mapped) {
+            return _image != nullptr;
+        }
+#ifdef _WIN32
+        return FlushViewOfFile(_image, 0) != 0;
+#else
+        return msync(_image, _image_size, MS_SYNC) == 0;
+#endif
+    }
+
+    void close() {
+        if (_image != nullptr) {
+            if (_mapped) {
+#ifdef _WIN32
+                UnmapViewOfFile(_image);
+                CloseHandle(_map);
+                CloseHandle(_file);
+                _map = nullptr;
+                _file = INVALID_HANDLE_VALUE;
+#else
+                munmap(_image, _image_size);
+#endif
+            }
+            else {
+                ::operator delete(_image, std::align_val_t{PAGE});
+            }
+        }
+        _image = nullptr;
+        _mapped = false;
+        _size = 0;
+        _header_size = 0;
+        _image_size = 0;
+    }
+
+private:
+    bool layout(const std::vector<size_t>& shape) {
+        _shape = shape;
+        _size = 1;
+        for (size_t dim : shape) {
+            _size *= dim;
+        }
+        _header = npy_header(npy_descr<T>(), shape, PAGE);
+        _header_size = _header.size();
+        _image_size = _header_size + _size * sizeof(T);
+        return _header_size > 0;
+    }
+
+    void finish_open() {
+        if (_image != nullptr) {
+            std::memcpy(_image, _header.data(), _header_size);
+        }
+        _header = std::string{};
+    }
+
+    bool map(const char* path) {
+#ifdef _WIN32
+        _file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (_file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        uint64_t size = (uint64_t)_image_size;
+        _map = CreateFileMappingA(_file, nullptr, PAGE_READWRITE, (DWORD)(size >> 32),
+                                  (DWORD)(size & 0xffffffff), nullptr);
+        if (_map != nullptr) {
+            _image = (unsigned char*)MapViewOfFile(_map, FILE_MAP_WRITE, 0, 0, 0);
+        }
+        if (_image == nullptr) {
+            if (_map != nullptr) {
+                CloseHandle(_map);
+            }
+            CloseHandle(_file);
+            _map = nullptr;
+            _file = INVALID_HANDLE_VALUE;
+            return false;
+        }
+        return true;
+#else
+        int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        if (ftruncate(fd, (off_t)_image_size) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* image = mmap(nullptr, _image_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (image == MAP_FAILED) {
+            return false;
+        }
+        _image = (unsigned char*)image;
+        return true;
+#endif
+    }
+
+private:
+    std::vector<size_t> _shape{};
+    std::string _header{};
+    size_t _size = 0;
+    size_t _header_size = 0;
+    size_t _image_size = 0;
+    unsigned char* _image = nullptr;
+    bool _mapped = false;
+#ifdef _WIN32
+    HANDLE _file = INVALID_HANDLE_VALUE;
+    HANDLE _map = nullptr;
+#endif
+};
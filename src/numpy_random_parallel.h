@@ -0,0 +1,262 @@
+#pragma once
+#include <condition_variable>
+#if defined(__has_include)
+#if __has_include(<execution>)
+#include <execution>
+#endif
+#endif
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "numpy_random.h"
+#include "numpy_random_counter.h"
+
+/*
+Fixed pool of worker threads, `run` splits the task indices evenly between the workers and an idle
+worker steals the back half of the busiest looking range it finds. The calling thread takes part
+as worker 0 so a pool of 1 thread runs everything inline.
+*/
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t threads) : _ranges(threads > 0 ? threads : 1) {
+        for (size_t i = 1; i < _ranges.size(); i++) {
+            _workers.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard lock{_mutex};
+            _stop = true;
+        }
+        _start_cv.notify_all();
+        for (auto& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    size_t threads() const {
+        return _ranges.size();
+    }
+
+    /* Calls **fn(task)** once for every task in [0, n_tasks) and returns when all are done. */
+    template <typename Fn>
+    void run(size_t n_tasks, Fn&& fn) {
+        std::lock_guard run_lock{_run_mutex};
+        size_t n_workers = _ranges.size();
+        for (size_t i = 0; i < n_workers; i++) {
+            std::lock_guard lock{_ranges[i].mutex};
+            _ranges[i].begin = n_tasks * i / n_workers;
+            _ranges[i].end = n_tasks * (i + 1) / n_workers;
+        }
+
+        {
+            std::lock_guard lock{_mutex};
+            _job = std::ref(fn);
+            _active = n_workers - 1;
+            _generation++;
+        }
+        _start_cv.notify_all();
+
+        work(0);
+
+        std::unique_lock lock{_mutex};
+        _done_cv.wait(lock, [this]() { return _active == 0; });
+        _job = nullptr;
+    }
+
+private:
+    struct alignas(64) task_range {
+        std::mutex mutex{};
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    void worker_loop(size_t idx) {
+        size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock lock{_mutex};
+                _start_cv.wait(lock, [&]() { return _stop || _generation != seen; });
+                if (_stop) {
+                    return;
+                }
+                seen = _generation;
+            }
+            work(idx);
+            {
+                std::lock_guard lock{_mutex};
+                _active--;
+            }
+            _done_cv.notify_one();
+        }
+    }
+
+    void work(size_t idx) {
+        size_t task = 0;
+        while (pop(idx, task) || steal(idx, task)) {
+            _job(task);
+        }
+    }
+
+    bool pop(size_t idx, size_t& task) {
+        auto& range = _ranges[idx];
+        std::lock_guard lock{range.mutex};
+        if (range.begin >= range.end) {
+            return false;
+        }
+        task = range.begin++;
+        return true;
+    }
+
+    bool steal(size_t idx, size_t& task) {
+        size_t n_workers = _ranges.size();
+        for (size_t k = 1; k < n_workers; k++) {
+            auto& victim = _ranges[(idx + k) % n_workers];
+            size_t begin = 0, end = 0;
+            {
+                std::lock_guard lock{victim.mutex};
+                if (victim.begin >= victim.end) {
+                    continue;
+                }
+                end = victim.end;
+                begin = end - (end - victim.begin + 1) / 2;
+                victim.end = begin;
+            }
+            auto& own = _ranges[idx];
+            std::lock_guard lock{own.mutex};
+            own.begin = begin + 1;
+            own.end = end;
+            task = begin;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    std::vector<task_range> _ranges;
+    std::vector<std::thread> _workers;
+
+    std::mutex _run_mutex{};
+    std::mutex _mutex{};
+    std::condition_variable _start_cv{};
+    std::condition_variable _done_cv{};
+    std::function<void(size_t)> _job{};
+    size_t _generation = 0;
+    size_t _active = 0;
+    bool _stop = false;
+};
+
+/* Engine for block **block** of the stream keyed by **key**. The block index goes in the top
+counter word, so blocks never overlap unless one of them draws 2^192 blocks. */
+template <typename Engine = Philox4x64>
+Engine block_substream(const typename Engine::key_type& key, uint64_t block) {
+    typename Engine::counter_type counter{};
+    counter[3] = block;
+    return Engine(key, counter);
+}
+
+/* Ready made distributions for parallel_fill, any callable taking
+`(RandomState<Engine>&, T* out, size_t cnt)` works too. */
+namespace parallel_dist {
+struct standard_uniform {
+    template <typename RngEngine>
+    void operator()(RandomState<RngEngine>& state, double* out, size_t cnt) const {
+        state.standard_uniform_fill(out, cnt);
+    }
+};
+
+struct standard_normal {
+    template <typename RngEngine>
+    void operator()(RandomState<RngEngine>& state, double* out, size_t cnt) const {
+        state.standard_normal_fill(out, cnt);
+    }
+};
+
+struct uint64 {
+    template <typename RngEngine>
+    void operator()(RandomState<RngEngine>& state, uint64_t* out, size_t cnt) const {
+        state.uint64_fill(out, cnt);
+    }
+};
+
+struct bernoulli {
+    double p;
+
+    template <typename RngEngine>
+    void operator()(RandomState<RngEngine>& state, uint8_t* out, size_t cnt) const {
+        state.bernoulli_fill(p, out, cnt);
+    }
+};
+} // namespace parallel_dist
+
+/*
+Fills **out** with **cnt** draws of **dist** split into **block_size** element blocks. Block b is
+drawn from its own counter-based substream, block_substream(key, b), so the output only depends on
+the key and the block size, it is bit-identical for any number of threads.
+
+**first_block** numbers the blocks from there, so an array produced a buffer at a time, each a
+multiple of block_size, is the same as one parallel_fill over the whole array.
+*/
+template <typename Engine = Philox4x64, typename Dist, typename T>
+void parallel_fill(const Dist& dist, T* out, size_t cnt, const typename Engine::key_type& key,
+                   WorkStealingPool& pool, size_t block_size = 65536, uint64_t first_block = 0) {
+    if (cnt == 0 || block_size == 0) {
+        return;
+    }
+    size_t n_blocks = (cnt + block_size - 1) / block_size;
+    pool.run(n_blocks, [&](size_t block) {
+        size_t first = block * block_size;
+        size_t n = cnt - first < block_size ? cnt - first : block_size;
+        RandomState<Engine> state(block_substream<Engine>(key, first_block + (uint64_t)block));
+        dist(state, out + first, n);
+    });
+}
+
+template <typename Engine = Philox4x64, typename Dist, typename T>
+void parallel_fill(const Dist& dist, T* out, size_t cnt, const typename Engine::key_type& key,
+                   size_t threads, size_t block_size = 65536, uint64_t first_block = 0) {
+    WorkStealingPool pool(threads);
+    parallel_fill<Engine>(dist, out, cnt, key, pool, block_size, first_block);
+}
+
+/* Contiguous range overloads, eg. a std::vector<double>. */
+template <typename Engine = Philox4x64, typename Dist, typename Range,
+          std::enable_if_t<!std::is_pointer_v<std::decay_t<Range>>, bool> = true>
+void parallel_fill(const Dist& dist, Range&& out, const typename Engine::key_type& key,
+                   WorkStealingPool& pool, size_t block_size = 65536, uint64_t first_block = 0) {
+    parallel_fill<Engine>(dist, std::data(out), (size_t)std::size(out), key, pool, block_size,
+                          first_block);
+}
+
+template <typename Engine = Philox4x64, typename Dist, typename Range,
+          std::enable_if_t<!std::is_pointer_v<std::decay_t<Range>>, bool> = true>
+void parallel_fill(const Dist& dist, Range&& out, const typename Engine::key_type& key,
+                   size_t threads, size_t block_size = 65536, uint64_t first_block = 0) {
+    parallel_fill<Engine>(dist, std::data(out), (size_t)std::size(out), key, threads, block_size,
+                          first_block);
+}
+
+#ifdef __cpp_lib_execution
+/*
+Standard execution policy spelling, `parallel_fill(std::execution::par_unseq, dist, out, key)`.
+The sequenced policy runs on the calling thread, the parallel ones on one thread per core. The
+values are the same for every policy.
+*/
+template <typename Engine = Philox4x64, typename Policy, typename Dist, typename Range,
+          std::enable_if_t<std::is_execution_policy_v<std::decay_t<Policy>>, bool> = true>
+void parallel_fill(Policy&&, const Dist& dist, Range&& out, const typename Engine::key_type& key,
+                   size_t block_size = 65536) {
+    size_t threads = 1;
+    if constexpr (!std::is_same_v<std::decay_t<Policy>, std::execution::sequenced_policy>) {
+        threads = (size_t)std::thread::hardware_concurrency();
+    }
+    parallel_fill<Engine>(dist, std::forward<Range>(out), key, threads, block_size);
+}
+#endif
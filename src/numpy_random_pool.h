@@ -0,0 +1,276 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include "numpy_random.h"
+
+extern "C" {
+#include "numpy/random/bitgen.h"
+#include "numpy/random/distributions.h"
+#include "numpy/random/legacy/legacy-distributions.h"
+}
+
+/*
+Many small independent generators, eg. one per agent of a simulation, kept in one arena in struct
+of arrays form: the engines back to back, then the cached legacy gauss values, then the half used
+32 bit words. Per agent that is sizeof(RngEngine) + 14 bytes instead of a whole RandomState with its
+mutex, deque and C structs.
+
+Agent i draws exactly what a `RandomState<RngEngine>` seeded with `seed_seq.spawn(n_agents)[i]`
+draws. The batched calls take one draw per agent for the agents [first, first + cnt) and write it
+to out[agent - first]. The pool has no lock, calls on disjoint agent ranges may run concurrently.
+Only engines returning a plain arithmetic type are supported.
+*/
+template <typename RngEngine>
+class RandomStatePool {
+    using RngReturn = raw_type<decltype(std::declval<RngEngine>()())>;
+
+    static_assert(std::is_arithmetic_v<RngReturn>,
+                  "RandomStatePool only supports engines returning an arithmetic type.");
+
+    static_assert(!RandomState<RngEngine>::is_wide,
+                  "RandomStatePool does not support 128 bit engines, use RandomState.");
+
+    static constexpr bool is_32bit = RandomState<RngEngine>::is_32bit;
+
+public:
+    static constexpr size_t all = (size_t)-1;
+
+    /* The engine must be seedable from a seed sequence, eg. `pcg32::seed(SeedSeq&)`. Children are
+    spawned a chunk at a time so seeding millions of agents never holds millions of sequences. */
+    template <typename result_type, size_t pool_size>
+    RandomStatePool(NumpySeedSequence<result_type, pool_size>& seed_seq, size_t n_agents)
+        : _size(n_agents) {
+        allocate();
+
+        constexpr size_t SEED_CHUNK = 4096;
+        for (size_t first = 0; first < _size; first += SEED_CHUNK) {
+            size_t cnt = std::min(SEED_CHUNK, _size - first);
+            auto children = seed_seq.spawn(cnt);
+            for (size_t i = 0; i < cnt; i++) {
+                _engines[first + i].seed(children[i]);
+            }
+        }
+    }
+
+    RandomStatePool(const RandomStatePool&) = delete;
+    RandomStatePool& operator=(const RandomStatePool&) = delete;
+
+    ~RandomStatePool() {
+        for (size_t i = 0; i < _size; i++) {
+            _engines[i].~RngEngine();
+        }
+        ::operator delete(_arena, std::align_val_t{64});
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    RngEngine& engine(size_t agent) {
+        return _engines[agent];
+    }
+
+    void uniform(double low, double high, double* out, size_t first = 0, size_t cnt = all) {
+        double range = high - low;
+        if (!std::isfinite(range)) {
+            std::fill(out, out + clamp(first, cnt), 0.0);
+            return;
+        }
+        each(first, cnt, [&](size_t i, bitgen_t* bitgen_state, aug_bitgen_t*) {
+            out[i] = random_uniform(bitgen_state, low, range);
+        });
+    }
+
+    /* Legacy polar gauss, every agent keeps its own cached second value like RandomState::rand_n. */
+    void rand_n(double* out, size_t first = 0, size_t cnt = all) {
+        each(first, cnt, [&](size_t i, bitgen_t*, aug_bitgen_t* aug_state) {
+            out[i] = legacy_gauss(aug_state);
+        });
+    }
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>,
+                                           bool> = true>
+    void rand_int(T low, T high, T* out, size_t first = 0, size_t cnt = all) {
+        /* The kernel's own fixed width type, `long long` and `long` are distinct types even where
+        both are 64 bits, and so are their unsigned pointers. */
+        using U = std::conditional_t<
+            sizeof(T) == sizeof(uint8_t), uint8_t,
+            std::conditional_t<sizeof(T) == sizeof(uint16_t), uint16_t,
+                               std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t,
+                                                  uint64_t>>>;
+        static_assert(sizeof(T) <= sizeof(uint64_t), "rand_int supports at most 64 bit types");
+        U off = (U)low, rng = (U)((U)high - (U)low);
+        each(first, cnt, [&](size_t i, bitgen_t* bitgen_state, aug_bitgen_t*) {
+            U value = 0;
+            if constexpr (sizeof(T) == sizeof(uint8_t)) {
+                random_bounded_uint8_fill(bitgen_state, off, rng, 1, true, &value);
+            }
+            else if constexpr (sizeof(T) == sizeof(uint16_t)) {
+                random_bounded_uint16_fill(bitgen_state, off, rng, 1, true, &value);
+            }
+            else if constexpr (sizeof(T) == sizeof(uint32_t)) {
+                random_bounded_uint32_fill(bitgen_state, off, rng, 1, true, &value);
+            }
+            else {
+                random_bounded_uint64_fill(bitgen_state, off, rng, 1, true, &value);
+            }
+            out[i] = (T)value;
+        });
+    }
+
+    void beta(double a, double b, double* out, size_t first = 0, size_t cnt = all) {
+        each(first, cnt, [&](size_t i, bitgen_t*, aug_bitgen_t* aug_state) {
+            out[i] = legacy_beta(aug_state, a, b);
+        });
+    }
+
+    /* The BTPE setup is shared by the whole batch instead of cached per agent, it only depends on
+    (n, p) so the draws are unchanged. */
+    void binomial(int64_t n, double p, int64_t* out, size_t first = 0, size_t cnt = all) {
+        binomial_t binomial{};
+        each(first, cnt, [&](size_t i, bitgen_t* bitgen_state, aug_bitgen_t*) {
+            out[i] = legacy_random_binomial(bitgen_state, p, n, &binomial);
+        });
+    }
+
+    /* Runs **fn(bitgen_t*, aug_bitgen_t*)** on the state of **agent**, for any other kernel. */
+    template <typename Fn>
+    void with_agent(size_t agent, Fn&& fn) {
+        each(agent, 1, [&](size_t, bitgen_t* bitgen_state, aug_bitgen_t* aug_state) {
+            fn(bitgen_state, aug_state);
+        });
+    }
+
+private:
+    struct agent_ref {
+        RngEngine* engine;
+        uint32_t* uinteger;
+        uint8_t* has_integer;
+    };
+
+    void allocate() {
+        size_t engines_size = align(_size * sizeof(RngEngine));
+        size_t gauss_size = align(_size * sizeof(double));
+        size_t uintegers_size = align(_size * sizeof(uint32_t));
+        size_t flags_size = align(_size * sizeof(uint8_t));
+
+        _arena = (unsigned char*)::operator new(
+            engines_size + gauss_size + uintegers_size + 2 * flags_size, std::align_val_t{64});
+        unsigned char* ptr = _arena;
+        _engines = (RngEngine*)ptr;
+        ptr += engines_size;
+        _gauss = (double*)ptr;
+        ptr += gauss_size;
+        _uintegers = (uint32_t*)ptr;
+        ptr += uintegers_size;
+        _has_gauss = ptr;
+        ptr += flags_size;
+        _has_integer = ptr;
+
+        for (size_t i = 0; i < _size; i++) {
+            new (&_engines[i]) RngEngine();
+            _gauss[i] = 0.0;
+            _uintegers[i] = 0;
+            _has_gauss[i] = 0;
+            _has_integer[i] = 0;
+        }
+    }
+
+    static size_t align(size_t bytes) {
+        return (bytes + 63) & ~(size_t)63;
+    }
+
+    size_t clamp(size_t first, size_t cnt) const {
+        if (first >= _size) {
+            return 0;
+        }
+        return std::min(cnt, _size - first);
+    }
+
+    /* Binds a transient bitgen/aug_bitgen pair to each agent in turn and writes the cached gauss
+    back afterwards. */
+    template <typename Fn>
+    void each(size_t first, size_t cnt, Fn&& fn) {
+        cnt = clamp(first, cnt);
+        agent_ref ref{};
+        bitgen_t bitgen_state{};
+        bitgen_state.state = &ref;
+        bitgen_state.next_uint64 = &next_uint64;
+        bitgen_state.next_uint32 = &next_uint32;
+        bitgen_state.next_double = &next_double;
+        bitgen_state.next_raw = &next_raw;
+        aug_bitgen_t aug_state{};
+        aug_state.bit_generator = &bitgen_state;
+
+        for (size_t i = 0; i < cnt; i++) {
+            size_t agent = first + i;
+            ref.engine = &_engines[agent];
+            ref.uinteger = &_uintegers[agent];
+            ref.has_integer = &_has_integer[agent];
+            aug_state.has_gauss = _has_gauss[agent];
+            aug_state.gauss = _gauss[agent];
+
+            fn(i, &bitgen_state, &aug_state);
+
+            _has_gauss[agent] = (uint8_t)aug_state.has_gauss;
+            _gauss[agent] = aug_state.gauss;
+        }
+    }
+
+    static uint64_t next_uint64(void* ptr) {
+        auto& ref = *(agent_ref*)ptr;
+        if constexpr (is_32bit) {
+            uint64_t hi = (uint64_t)(*ref.engine)();
+            return hi << 32 | (uint64_t)(*ref.engine)();
+        }
+        else {
+            return (uint64_t)(*ref.engine)();
+        }
+    }
+
+    static uint32_t next_uint32(void* ptr) {
+        auto& ref = *(agent_ref*)ptr;
+        if constexpr (is_32bit) {
+            return (uint32_t)(*ref.engine)();
+        }
+        else {
+            if (*ref.has_integer) {
+                *ref.has_integer = 0;
+                return *ref.uinteger;
+            }
+            uint64_t next = (uint64_t)(*ref.engine)();
+            *ref.has_integer = 1;
+            *ref.uinteger = (uint32_t)(next >> 32);
+            return (uint32_t)(next & 0xffffffff);
+        }
+    }
+
+    static double next_double(void* ptr) {
+        auto& ref = *(agent_ref*)ptr;
+        if constexpr (is_32bit) {
+            int32_t a = (*ref.engine)() >> 5, b = (*ref.engine)() >> 6;
+            return (a * 67108864.0 + b) / 9007199254740992.0;
+        }
+        else {
+            uint64_t rnd = (uint64_t)(*ref.engine)();
+            return (double)((rnd >> 11) * (1.0 / 9007199254740992.0));
+        }
+    }
+
+    static uint64_t next_raw(void* ptr) {
+        return (uint64_t)(*(*(agent_ref*)ptr).engine)();
+    }
+
+private:
+    size_t _size;
+    unsigned char* _arena = nullptr;
+
+    RngEngine* _engines = nullptr;
+    double* _gauss = nullptr;
+    uint32_t* _uintegers = nullptr;
+    uint8_t* _has_gauss = nullptr;
+    uint8_t* _has_integer = nullptr;
+};
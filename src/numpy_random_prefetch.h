@@ -0,0 +1,248 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "numpy_random.h"
+
+/* Single producer single consumer ring, the producer writes straight into the storage through
+write_region/commit so the bulk kernels can fill it without an intermediate copy. */
+template <typename T>
+class spsc_ring {
+public:
+    explicit spsc_ring(size_t capacity) : _buffer(capacity), _mask(capacity - 1) {}
+
+    /* Consumer side. */
+    bool pop(T& out) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail_cache) {
+            _tail_cache = _tail.load(std::memory_order_acquire);
+            if (head == _tail_cache) {
+                return false;
+            }
+        }
+        out = _buffer[head & _mask];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* Consumer side, lower bound of the buffered count without touching the producer's line. */
+    size_t cached_size() const {
+        return _tail_cache - _head.load(std::memory_order_relaxed);
+    }
+
+    /* Producer side, returns the largest contiguous writable region. */
+    T* write_region(size_t& cnt) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t free = _buffer.size() - (tail - _head.load(std::memory_order_acquire));
+        size_t to_end = _buffer.size() - (tail & _mask);
+        cnt = free < to_end ? free : to_end;
+        return &_buffer[tail & _mask];
+    }
+
+    /* Producer side, publishes **cnt** elements written through write_region. */
+    void commit(size_t cnt) {
+        _tail.store(_tail.load(std::memory_order_relaxed) + cnt, std::memory_order_release);
+    }
+
+    size_t capacity() const {
+        return _buffer.size();
+    }
+
+private:
+    std::vector<T> _buffer;
+    size_t _mask;
+
+    alignas(64) std::atomic<size_t> _head{0};
+    size_t _tail_cache = 0;
+
+    alignas(64) std::atomic<size_t> _tail{0};
+};
+
+/*
+A background thread keeps per consumer rings of uniforms, standard normals and raw 64 bit words
+topped up through the RandomState bulk fills. Consumers pop without locks or C callbacks, and only
+wake the producer once a ring drops under a quarter of its capacity.
+
+Every ring is backed by its own RandomState seeded from a spawned child of the given seed sequence,
+so the values a consumer sees only depend on the seed and the consumer index, never on how the
+producer happened to interleave its refills. Each Consumer must only be used from one thread at a
+time. The normals come from the ziggurat fill, not the legacy rand_n stream.
+*/
+template <typename RngEngine>
+class PrefetchingRandomState {
+public:
+    class Consumer {
+        friend class PrefetchingRandomState<RngEngine>;
+
+    public:
+        double uniform() {
+            return pop(_uniforms);
+        }
+
+        double standard_normal() {
+            return pop(_normals);
+        }
+
+        uint64_t next_uint64() {
+            return pop(_raws);
+        }
+
+    private:
+        Consumer(PrefetchingRandomState* owner, size_t capacity)
+            : _owner(owner), _uniforms(capacity), _normals(capacity), _raws(capacity) {}
+
+        template <typename T>
+        T pop(spsc_ring<T>& ring) {
+            T out;
+            while (!ring.pop(out)) {
+                request_refill();
+                std::this_thread::yield();
+            }
+            if (ring.cached_size() <= ring.capacity() / 4 &&
+                !_refill_requested.load(std::memory_order_relaxed)) {
+                request_refill();
+            }
+            return out;
+        }
+
+        void request_refill() {
+            if (!_refill_requested.exchange(true, std::memory_order_acq_rel)) {
+                _owner->wake();
+            }
+        }
+
+        PrefetchingRandomState* _owner;
+
+        spsc_ring<double> _uniforms;
+        spsc_ring<double> _normals;
+        spsc_ring<uint64_t> _raws;
+
+        alignas(64) std::atomic<bool> _refill_requested{false};
+
+        /* Only touched by the producer thread. */
+        std::unique_ptr<RandomState<RngEngine>> _uniform_state;
+        std::unique_ptr<RandomState<RngEngine>> _normal_state;
+        std::unique_ptr<RandomState<RngEngine>> _raw_state;
+    };
+
+    /* **capacity** is rounded up to a power of two. The engine must be seedable from a seed
+    sequence, eg. `std::mt19937::seed(SeedSeq&)` or `pcg64::seed(SeedSeq&)`. */
+    template <typename result_type, size_t pool_size>
+    PrefetchingRandomState(NumpySeedSequence<result_type, pool_size>& seed_seq, size_t n_consumers,
+                           size_t capacity = 4096) {
+        size_t pow2 = 64;
+        while (pow2 < capacity) {
+            pow2 <<= 1;
+        }
+
+        auto children = seed_seq.spawn(n_consumers);
+        _consumers.reserve(n_consumers);
+        for (auto& child : children) {
+            std::unique_ptr<Consumer> consumer{new Consumer(this, pow2)};
+            auto grandchildren = child.spawn(3);
+            consumer->_uniform_state = make_state(grandchildren[0]);
+            consumer->_normal_state = make_state(grandchildren[1]);
+            consumer->_raw_state = make_state(grandchildren[2]);
+            _consumers.push_back(std::move(consumer));
+        }
+
+        refill_all();
+        _producer = std::thread([this]() { run(); });
+    }
+
+    PrefetchingRandomState(const PrefetchingRandomState&) = delete;
+    PrefetchingRandomState& operator=(const PrefetchingRandomState&) = delete;
+
+    ~PrefetchingRandomState() {
+        {
+            std::lock_guard lock{_wake_mutex};
+            _stop = true;
+        }
+        _wake_cv.notify_one();
+        _producer.join();
+    }
+
+    Consumer& consumer(size_t idx) {
+        return *_consumers[idx];
+    }
+
+    size_t consumers() const {
+        return _consumers.size();
+    }
+
+private:
+    template <typename SeedSeq>
+    static std::unique_ptr<RandomState<RngEngine>> make_state(SeedSeq& seed_seq) {
+        std::unique_ptr<RandomState<RngEngine>> state{new RandomState<RngEngine>()};
+        state->get_engine().seed(seed_seq);
+        return state;
+    }
+
+    template <typename T, typename Fill>
+    static bool refill(spsc_ring<T>& ring, Fill&& fill) {
+        bool filled = false;
+        size_t cnt = 0;
+        T* region = ring.write_region(cnt);
+        /* Small refills only happen around the wrap point, take them anyway so the ring stays
+        full. */
+        while (cnt > 0) {
+            fill(region, cnt);
+            ring.commit(cnt);
+            filled = true;
+            region = ring.write_region(cnt);
+        }
+        return filled;
+    }
+
+    bool refill_all() {
+        bool filled = false;
+        for (auto& consumer : _consumers) {
+            consumer->_refill_requested.store(false, std::memory_order_release);
+            filled |= refill(consumer->_uniforms, [&](double* out, size_t cnt) {
+                consumer->_uniform_state->standard_uniform_fill(out, cnt);
+            });
+            filled |= refill(consumer->_normals, [&](double* out, size_t cnt) {
+                consumer->_normal_state->standard_normal_fill(out, cnt);
+            });
+            filled |= refill(consumer->_raws, [&](uint64_t* out, size_t cnt) {
+                consumer->_raw_state->uint64_fill(out, cnt);
+            });
+        }
+        return filled;
+    }
+
+    void wake() {
+        {
+            std::lock_guard lock{_wake_mutex};
+            _pending = true;
+        }
+        _wake_cv.notify_one();
+    }
+
+    void run() {
+        for (;;) {
+            {
+                std::unique_lock lock{_wake_mutex};
+                _wake_cv.wait(lock, [this]() { return _pending || _stop; });
+                if (_stop) {
+                    return;
+                }
+                _pending = false;
+            }
+            refill_all();
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<Consumer>> _consumers;
+
+    std::mutex _wake_mutex{};
+    std::condition_variable _wake_cv{};
+    bool _pending = false;
+    bool _stop = false;
+
+    std::thread _producer;
+};
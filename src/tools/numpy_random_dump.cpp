@@ -0,0 +1,163 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "numpy_random.h"
+#include "numpy_random_counter.h"
+#include "numpy_random_mapped.h"
+
+/*
+Dumps a RandomState stream into a pool file for MappedRandomSource.
+
+    numpy_random_dump <out> <count> [--engine mt19937_64|philox4x64] [--seed N]
+                      [--dist raw|standard_uniform|standard_normal|normal|uniform|rand_int]
+                      [--params a b]
+
+`raw` writes the engine's 64 bit words, which RandomState<MappedRandomSource> replays exactly. The
+other distributions write doubles, rand_int writes int64 values, `normal` is the legacy rand_n
+scaled by the params.
+*/
+namespace {
+constexpr size_t CHUNK = 1 << 16;
+
+struct options {
+    const char* out = nullptr;
+    uint64_t count = 0;
+    const char* engine = "mt19937_64";
+    uint64_t seed = 0;
+    const char* dist = "raw";
+    double params[2] = {0.0, 1.0};
+};
+
+const char* const DISTS[] = {"raw",    "standard_uniform", "standard_normal",
+                             "normal", "uniform",          "rand_int"};
+
+bool known_dist(const char* dist) {
+    for (const char* name : DISTS) {
+        if (std::strcmp(dist, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int usage() {
+    std::fprintf(stderr,
+                 "usage: numpy_random_dump <out> <count> [--engine mt19937_64|philox4x64] "
+                 "[--seed N]\n"
+                 "                         [--dist raw|standard_uniform|standard_normal|normal|"
+                 "uniform|rand_int]\n"
+                 "                         [--params a b]\n");
+    return 1;
+}
+
+bool parse(int argc, char** argv, options& opts) {
+    if (argc < 3) {
+        return false;
+    }
+    opts.out = argv[1];
+    opts.count = std::strtoull(argv[2], nullptr, 10);
+    for (int i = 3; i < argc; i++) {
+        if (std::strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            opts.engine = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            opts.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--dist") == 0 && i + 1 < argc) {
+            opts.dist = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--params") == 0 && i + 2 < argc) {
+            opts.params[0] = std::strtod(argv[++i], nullptr);
+            opts.params[1] = std::strtod(argv[++i], nullptr);
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename RngEngine>
+int dump(const options& opts) {
+    NumpySeedSequence<uint32_t> seed_seq(opts.seed);
+    RandomState<RngEngine> random;
+    random.get_engine().seed(seed_seq);
+
+    bool is_int = std::strcmp(opts.dist, "raw") == 0 || std::strcmp(opts.dist, "rand_int") == 0;
+    auto header = MappedPoolHeader::make(opts.engine, opts.dist, opts.seed, 8);
+    header.params[0] = opts.params[0];
+    header.params[1] = opts.params[1];
+
+    MappedPoolWriter writer;
+    if (!writer.open(opts.out, header)) {
+        std::fprintf(stderr, "numpy_random_dump: can not open %s\n", opts.out);
+        return 1;
+    }
+
+    std::vector<uint64_t> words(is_int ? CHUNK : 0);
+    std::vector<double> values(is_int ? 0 : CHUNK);
+    for (uint64_t done = 0; done < opts.count;) {
+        size_t cnt = (size_t)(opts.count - done < CHUNK ? opts.count - done : CHUNK);
+        const void* chunk = is_int ? (const void*)words.data() : (const void*)values.data();
+
+        if (std::strcmp(opts.dist, "raw") == 0) {
+            random.uint64_fill(words.data(), cnt);
+        }
+        else if (std::strcmp(opts.dist, "rand_int") == 0) {
+            for (size_t i = 0; i < cnt; i++) {
+                words[i] = (uint64_t)random.rand_int((int64_t)opts.params[0],
+                                                     (int64_t)opts.params[1]);
+            }
+        }
+        else if (std::strcmp(opts.dist, "standard_uniform") == 0) {
+            random.standard_uniform_fill(values.data(), cnt);
+        }
+        else if (std::strcmp(opts.dist, "standard_normal") == 0) {
+            random.standard_normal_fill(values.data(), cnt);
+        }
+        else if (std::strcmp(opts.dist, "normal") == 0) {
+            for (size_t i = 0; i < cnt; i++) {
+                values[i] = opts.params[0] + opts.params[1] * random.template rand_n<double>();
+            }
+        }
+        else if (std::strcmp(opts.dist, "uniform") == 0) {
+            for (size_t i = 0; i < cnt; i++) {
+                values[i] = random.uniform(opts.params[0], opts.params[1]);
+            }
+        }
+
+        if (!writer.write(chunk, cnt)) {
+            std::fprintf(stderr, "numpy_random_dump: write to %s failed\n", opts.out);
+            return 1;
+        }
+        done += cnt;
+    }
+    return writer.close() ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts;
+    if (!parse(argc, argv, opts)) {
+        return usage();
+    }
+    /* Checked before anything is written, the header names the distribution. */
+    if (!known_dist(opts.dist)) {
+        std::fprintf(stderr, "numpy_random_dump: unknown distribution %s\n", opts.dist);
+        return usage();
+    }
+    if (opts.count == 0) {
+        std::fprintf(stderr, "numpy_random_dump: <count> must be at least 1\n");
+        return usage();
+    }
+    if (std::strcmp(opts.engine, "mt19937_64") == 0) {
+        return dump<std::mt19937_64>(opts);
+    }
+    if (std::strcmp(opts.engine, "philox4x64") == 0) {
+        return dump<Philox4x64>(opts);
+    }
+    std::fprintf(stderr, "numpy_random_dump: unknown engine %s\n", opts.engine);
+    return 1;
+}
@@ -0,0 +1,433 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "numpy_random.h"
+#include "numpy_random_npy.h"
+#include "numpy_random_parallel.h"
+
+/*
+Writes large synthetic datasets straight to disk.
+
+    numpy_random_gen <out> <count> [--dist standard_normal|standard_uniform|normal|uniform|
+                                           rand_int|bernoulli|raw]
+                     [--params a b] [--seed N] [--stream N] [--format raw|npy|chunked]
+                     [--chunk N] [--buffer N] [--threads N] [--direct]
+
+The values are parallel_fill over Philox4x64 keyed by {seed, stream} with 65536 value blocks, so a
+dataset only depends on the seed, stream, distribution and params, not on the thread count or the
+buffer size. Generation runs on a WorkStealingPool into one buffer while the previous buffer is
+written, `--direct` opens the output with O_DIRECT where the platform has it. `chunked` writes
+`<out>.00000.npy`, `<out>.00001.npy`, ... of at most --chunk values each. A <count> of 0 writes one
+empty file.
+*/
+namespace {
+constexpr size_t BLOCK = 65536;
+constexpr size_t DIRECT_ALIGN = 4096;
+
+struct options {
+    const char* out = nullptr;
+    uint64_t count = 0;
+    const char* dist = "standard_normal";
+    double params[2] = {0.0, 1.0};
+    uint64_t seed = 0;
+    uint64_t stream = 0;
+    const char* format = "npy";
+    uint64_t chunk = (uint64_t)1 << 27;
+    size_t buffer = (size_t)1 << 22;
+    size_t threads = 0;
+    bool direct = false;
+};
+
+namespace gen_dist {
+struct normal {
+    double loc, scale;
+
+    template <typename RngEngine>
+    void operator()(RandomState<RngEngine>& state, double* out, size_t cnt) const {
+        state.standard_normal_fill(out, cnt);
+        for (size_t i = 0; i < cnt; i++) {
+            out[i] = loc + scale * out[i];
+        }
+    }
+};
+
+/* Same arithmetic as random_uniform. */
+struct uniform {
+    double low, high;
+
+    template <typename RngEngine>
+    void operator()(RandomState<RngEngine>& state, double* out, size_t cnt) const {
+        state.standard_uniform_fill(out, cnt);
+        for (size_t i = 0; i < cnt; i++) {
+            out[i] = low + (high - low) * out[i];
+        }
+    }
+};
+
+struct rand_int {
+    int64_t low, high;
+
+    template <typename RngEngine>
+    void operator()(RandomState<RngEngine>& state, int64_t* out, size_t cnt) const {
+        for (size_t i = 0; i < cnt; i++) {
+            out[i] = state.rand_int(low, high);
+        }
+    }
+};
+} // namespace gen_dist
+
+struct aligned_buffer {
+    void* data = nullptr;
+
+    explicit aligned_buffer(size_t bytes) {
+        data = ::operator new(bytes, std::align_val_t{DIRECT_ALIGN});
+    }
+
+    aligned_buffer(const aligned_buffer&) = delete;
+    aligned_buffer& operator=(const aligned_buffer&) = delete;
+
+    ~aligned_buffer() {
+        ::operator delete(data, std::align_val_t{DIRECT_ALIGN});
+    }
+};
+
+/* Output file, with O_DIRECT every write but the last must be a multiple of DIRECT_ALIGN. */
+class sink {
+public:
+    sink() = default;
+    sink(const sink&) = delete;
+    sink& operator=(const sink&) = delete;
+
+    ~sink() {
+        close();
+    }
+
+    bool open(const std::string& path, bool direct) {
+        _size = 0;
+#ifdef _WIN32
+        _direct = false;
+        _file = std::fopen(path.c_str(), "wb");
+        return _file != nullptr;
+#else
+        int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+        _direct = direct;
+        if (direct) {
+            flags |= O_DIRECT;
+        }
+#else
+        _direct = false;
+#endif
+        _fd = ::open(path.c_str(), flags, 0644);
+        return _fd >= 0;
+#endif
+    }
+
+    bool direct() const {
+        return _direct;
+    }
+
+    /* **capacity** is the usable size of **data**, a direct write pads the tail up to it. */
+    bool write(const void* data, size_t bytes, size_t capacity) {
+        _size += bytes;
+#ifdef _WIN32
+        (void)capacity;
+        return std::fwrite(data, 1, bytes, _file) == bytes;
+#else
+        if (_direct && bytes % DIRECT_ALIGN != 0) {
+            size_t padded = (bytes + DIRECT_ALIGN - 1) / DIRECT_ALIGN * DIRECT_ALIGN;
+            if (padded > capacity) {
+                return false;
+            }
+            std::memset((unsigned char*)data + bytes, 0, padded - bytes);
+            _padded = true;
+            bytes = padded;
+        }
+        const unsigned char* ptr = (const unsigned char*)data;
+        while (bytes > 0) {
+            ssize_t written = ::write(_fd, ptr, bytes);
+            if (written <= 0) {
+                return false;
+            }
+            ptr += written;
+            bytes -= (size_t)written;
+        }
+        return true;
+#endif
+    }
+
+    bool close() {
+#ifdef _WIN32
+        if (_file == nullptr) {
+            return true;
+        }
+        bool ok = std::fclose(_file) == 0;
+        _file = nullptr;
+        return ok;
+#else
+        if (_fd < 0) {
+            return true;
+        }
+        bool ok = !_padded || ftruncate(_fd, (off_t)_size) == 0;
+        ok = ::close(_fd) == 0 && ok;
+        _fd = -1;
+        _padded = false;
+        return ok;
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    std::FILE* _file = nullptr;
+#else
+    int _fd = -1;
+    bool _padded = false;
+#endif
+    bool _direct = false;
+    uint64_t _size = 0;
+};
+
+int usage() {
+    std::fprintf(stderr,
+                 "usage: numpy_random_gen <out> <count>\n"
+                 "    [--dist standard_normal|standard_uniform|normal|uniform|rand_int|bernoulli|"
+                 "raw]\n"
+                 "    [--params a b] [--seed N] [--stream N] [--format raw|npy|chunked]\n"
+                 "    [--chunk N] [--buffer N] [--threads N] [--direct]\n");
+    return 1;
+}
+
+/* Whole unsigned decimal **text**, no sign, no trailing characters, no overflow. */
+bool parse_uint64(const char* text, uint64_t& value) {
+    if (text[0] < '0' || text[0] > '9') {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno == ERANGE || *end != '\0') {
+        return false;
+    }
+    value = (uint64_t)parsed;
+    return true;
+}
+
+bool parse_size(const char* text, size_t& value) {
+    uint64_t parsed = 0;
+    if (!parse_uint64(text, parsed) || parsed > (uint64_t)SIZE_MAX) {
+        return false;
+    }
+    value = (size_t)parsed;
+    return true;
+}
+
+bool parse_double(const char* text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text, &end);
+    return end != text && *end == '\0';
+}
+
+bool invalid(const char* what, const char* text) {
+    std::fprintf(stderr, "numpy_random_gen: invalid %s '%s'\n", what, text);
+    return false;
+}
+
+bool parse(int argc, char** argv, options& opts) {
+    if (argc < 3) {
+        return false;
+    }
+    opts.out = argv[1];
+    if (!parse_uint64(argv[2], opts.count)) {
+        return invalid("<count>", argv[2]);
+    }
+    for (int i = 3; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--dist") == 0 && has_value) {
+            opts.dist = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--params") == 0 && i + 2 < argc) {
+            if (!parse_double(argv[++i], opts.params[0])) {
+                return invalid("--params", argv[i]);
+            }
+            if (!parse_double(argv[++i], opts.params[1])) {
+                return invalid("--params", argv[i]);
+            }
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+            if (!parse_uint64(argv[++i], opts.seed)) {
+                return invalid("--seed", argv[i]);
+            }
+        }
+        else if (std::strcmp(argv[i], "--stream") == 0 && has_value) {
+            if (!parse_uint64(argv[++i], opts.stream)) {
+                return invalid("--stream", argv[i]);
+            }
+        }
+        else if (std::strcmp(argv[i], "--format") == 0 && has_value) {
+            opts.format = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--chunk") == 0 && has_value) {
+            if (!parse_uint64(argv[++i], opts.chunk) || opts.chunk == 0) {
+                return invalid("--chunk", argv[i]);
+            }
+        }
+        else if (std::strcmp(argv[i], "--buffer") == 0 && has_value) {
+            if (!parse_size(argv[++i], opts.buffer) || opts.buffer == 0) {
+                return invalid("--buffer", argv[i]);
+            }
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && has_value) {
+            /* 0 keeps the default, one thread per hardware thread. */
+            if (!parse_size(argv[++i], opts.threads)) {
+                return invalid("--threads", argv[i]);
+            }
+        }
+        else if (std::strcmp(argv[i], "--direct") == 0) {
+            opts.direct = true;
+        }
+        else {
+            return false;
+        }
+    }
+    if (std::strcmp(opts.format, "raw") != 0 && std::strcmp(opts.format, "npy") != 0 &&
+        std::strcmp(opts.format, "chunked") != 0) {
+        return invalid("--format", opts.format);
+    }
+    return true;
+}
+
+template <typename T, typename Dist>
+int generate(const options& opts, const Dist& dist) {
+    bool chunked = std::strcmp(opts.format, "chunked") == 0;
+    bool npy = chunked || std::strcmp(opts.format, "npy") == 0;
+
+    /* Whole blocks per buffer keep the block numbering, and with it the values, independent of
+    the buffer size, and whole buffers per chunk keep every write inside one file. */
+    size_t buffer = opts.buffer < BLOCK ? BLOCK : opts.buffer / BLOCK * BLOCK;
+    uint64_t chunk = chunked ? opts.chunk : opts.count;
+    if (chunked) {
+        chunk = chunk < buffer ? buffer : chunk / buffer * buffer;
+    }
+    size_t threads = opts.threads > 0 ? opts.threads : (size_t)std::thread::hardware_concurrency();
+
+    WorkStealingPool pool(threads);
+    Philox4x64::key_type key{opts.seed, opts.stream};
+    size_t capacity = buffer * sizeof(T);
+    aligned_buffer buffers[2]{aligned_buffer(capacity), aligned_buffer(capacity)};
+    aligned_buffer header_buffer(0x10000);
+
+    sink out;
+    std::future<bool> pending;
+    uint64_t file_idx = 0;
+    uint64_t file_end = 0;
+
+    /* Closes the current file and opens the next one for **n_values** values, with its header. */
+    auto open_next = [&](uint64_t n_values) {
+        if (!out.close()) {
+            return false;
+        }
+        std::string path = opts.out;
+        if (chunked) {
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), ".%05llu.npy", (unsigned long long)file_idx);
+            path += suffix;
+        }
+        file_idx++;
+
+        if (!out.open(path, opts.direct)) {
+            std::fprintf(stderr, "numpy_random_gen: can not open %s\n", path.c_str());
+            return false;
+        }
+        if (npy) {
+            std::string header = npy_header(npy_descr<T>(), {(size_t)n_values},
+                                            out.direct() ? DIRECT_ALIGN : 64);
+            std::memcpy(header_buffer.data, header.data(), header.size());
+            if (header.empty() || !out.write(header_buffer.data, header.size(), 0x10000)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    /* An empty dataset is still one valid, empty file. */
+    bool ok = opts.count > 0 || open_next(0);
+
+    for (uint64_t done = 0, step = 0; done < opts.count && ok; done += buffer, step++) {
+        size_t cnt = (size_t)(opts.count - done < buffer ? opts.count - done : buffer);
+        T* values = (T*)buffers[step % 2].data;
+        parallel_fill<Philox4x64>(dist, values, cnt, key, pool, BLOCK, done / BLOCK);
+
+        if (pending.valid()) {
+            ok = pending.get();
+        }
+        if (!ok) {
+            break;
+        }
+
+        if (done >= file_end) {
+            file_end = done + chunk < opts.count ? done + chunk : opts.count;
+            if (!open_next(file_end - done)) {
+                ok = false;
+                break;
+            }
+        }
+
+        pending = std::async(std::launch::async, [&out, values, cnt, capacity]() {
+            return out.write(values, cnt * sizeof(T), capacity);
+        });
+    }
+    if (pending.valid()) {
+        ok = pending.get() && ok;
+    }
+    ok = out.close() && ok;
+    if (!ok) {
+        std::fprintf(stderr, "numpy_random_gen: writing %s failed\n", opts.out);
+        return 1;
+    }
+    return 0;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts;
+    if (!parse(argc, argv, opts)) {
+        return usage();
+    }
+    std::string dist = opts.dist;
+    if (dist == "standard_normal") {
+        return generate<double>(opts, parallel_dist::standard_normal{});
+    }
+    if (dist == "standard_uniform") {
+        return generate<double>(opts, parallel_dist::standard_uniform{});
+    }
+    if (dist == "normal") {
+        return generate<double>(opts, gen_dist::normal{opts.params[0], opts.params[1]});
+    }
+    if (dist == "uniform") {
+        return generate<double>(opts, gen_dist::uniform{opts.params[0], opts.params[1]});
+    }
+    if (dist == "rand_int") {
+        return generate<int64_t>(
+            opts, gen_dist::rand_int{(int64_t)opts.params[0], (int64_t)opts.params[1]});
+    }
+    if (dist == "bernoulli") {
+        return generate<uint8_t>(opts, parallel_dist::bernoulli{opts.params[0]});
+    }
+    if (dist == "raw") {
+        return generate<uint64_t>(opts, parallel_dist::uint64{});
+    }
+    std::fprintf(stderr, "numpy_random_gen: unknown distribution %s\n", opts.dist);
+    return 1;
+}
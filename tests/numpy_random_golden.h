@@ -0,0 +1,169 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/* Generated by numpy_random_golden.py with NumPy 2.4.6, do not edit. */
+
+constexpr uint32_t golden_seeds[4] = {0u, 1u, 12345u, 4294967295u};
+constexpr size_t golden_draws = 8;
+
+constexpr double golden_uniform[4][8] = {
+    {0x1.7cf66afdb5d48p-1, 0x1.9371406715200p+0, 0x1.038980c94573cp+0, 0x1.72e6a48f1edc8p-1,
+     0x1.e473463c52b40p-4, 0x1.3abe953d80464p+0, 0x1.80e49e7cd8230p-3, 0x1.3abc16a4897b4p+1},
+    {0x1.5c9c53f8cb080p-4, 0x1.9a03ee15358cap+0, -0x1.ffda858b8005dp+0, -0x1.f40ea6809d33cp-2,
+     -0x1.4427079a39cbap+0, -0x1.89ce7d408c0dbp+0, -0x1.11964101ef2d2p+0, -0x1.16baa4d35ccf8p-2},
+    {0x1.52f44cf7365e4p+1, -0x1.ac283bac58eacp-2, -0x1.14957bd9a3739p+0, -0x1.f45360378a5a8p-1,
+     0x1.ad60466a43d28p-1, 0x1.f4982d3204e9cp-1, 0x1.694a0f14f4402p+1, 0x1.44111233cc508p+0},
+    {-0x1.8307efce24976p+0, 0x1.47ecce2d03f5ep+1, 0x1.f1f71674361eep+0, 0x1.e667943b4c612p+0,
+     -0x1.e9098712a150ap+0, 0x1.6c7bda1859d3cp+1, 0x1.ee87659e8f464p-1, -0x1.44f854901b868p+0},
+};
+
+constexpr double golden_standard_uniform[4][8] = {
+    {0x1.18fe1565f12a8p-1, 0x1.6e2d4cf608733p-1, 0x1.349d66b6e894bp-1, 0x1.16faedb6395f5p-1,
+     0x1.b1d2904fd0ef6p-2, 0x1.4ab2a21899b5bp-1, 0x1.c016dca6159d2p-2, 0x1.c8967883a12f7p-1},
+    {0x1.ab07d0ffa3c06p-2, 0x1.70ce5f3baf051p-1, 0x1.dfb906661c000p-14, 0x1.3596ab7fe08f4p-2,
+     0x1.2c8e5a3c7053cp-3, 0x1.7a3808cb0ca10p-4, 0x1.7d75fe634e1e4p-3, 0x1.61daabd5ba3cep-2},
+    {0x1.dbf6a3f8f84b7p-1, 0x1.43f7f410bb044p-2, 0x1.78aa6d0a2dad8p-3, 0x1.a2f07fd391514p-3,
+     0x1.22acdae20d908p-1, 0x1.30eb3c3d342ecp-1, 0x1.edd4d8dd90335p-1, 0x1.4e6d3a7b1e86ap-1},
+    {0x1.8fe69a3924820p-4, 0x1.d323d824032b1p-1, 0x1.93fc6f61af3f9p-1, 0x1.8f5ca1b151c07p-1,
+     0x1.25ec7244bbf80p-6, 0x1.f06314e047dc9p-1, 0x1.2fb4adec830e1p-1, 0x1.2b3f78b30728cp-3},
+};
+
+constexpr int64_t golden_rand_int64[4][8] = {
+    {-316LL, -441LL, 653LL, 216LL, -165LL, -237LL, 731LL, 383LL},
+    {61LL, -765LL, 932LL, 96LL, 791LL, -95LL, -285LL, 669LL},
+    {-518LL, 509LL, 309LL, -871LL, 444LL, 449LL, -618LL, 381LL},
+    {-581LL, -710LL, 36LL, 95LL, 972LL, 600LL, -786LL, -494LL},
+};
+
+constexpr int64_t golden_rand_int64_wide[4][8] = {
+    {741280623151LL, 506137267392LL, 291447657211LL, 841157541223LL, 41332891347LL, 91845220082LL,
+     155896724055LL, 300891291096LL},
+    {163196666091LL, 605300724808LL, 1095766950793LL, 876169207429LL, 340316410816LL,
+     620178591873LL, 877839392327LL, 1020783786492LL},
+    {974485794277LL, 125115435137LL, 704545402281LL, 1094471209342LL, 436076954146LL,
+     128661371649LL, 508790099313LL, 257370495630LL},
+    {700559016226LL, 53956357191LL, 775354646080LL, 922432766458LL, 933225791264LL, 547627168379LL,
+     1042369230955LL, 50248231114LL},
+};
+
+constexpr int32_t golden_rand_int32[4][8] = {
+    {5, -2, -7, -4, 4, -4, 0, 2},
+    {-2, 4, 5, 1, 2, 4, -2, -7},
+    {-5, -2, 6, -6, -3, 2, 7, 7},
+    {-4, -5, 5, 0, -3, -7, -1, 3},
+};
+
+constexpr uint8_t golden_rand_uint8[4][8] = {
+    {172, 47, 117, 192, 67, 82, 195, 103},
+    {37, 128, 140, 72, 126, 137, 170, 133},
+    {81, 45, 29, 129, 164, 169, 15, 126},
+    {163, 34, 12, 71, 180, 64, 80, 1},
+};
+
+constexpr double golden_rand_n[4][8] = {
+    {0x1.c398ef3e5cfa5p+0, 0x1.99c2cfacc8953p-2, 0x1.f51d25222c9abp-1, 0x1.1ed5969e3314ep+1,
+     0x1.de1847cb13ddap+0, -0x1.f45dc42a58c82p-1, 0x1.e671fd33295e9p-1, -0x1.35fac49d38436p-3},
+    {0x1.9fd5190657c50p+0, -0x1.393822fb7d9adp-1, -0x1.0e6c872548fd2p-1, -0x1.12ae1255cb80cp+0,
+     0x1.bb16b5735117dp-1, -0x1.2698d1ecca259p+1, 0x1.beabfbd8fc605p+0, -0x1.85bce931aaff6p-1},
+    {-0x1.a33dc4f5d203dp-3, 0x1.ea701f566080fp-2, -0x1.09f3df0ae3d0ep-1, -0x1.1c88aeb5231f1p-1,
+     0x1.f73d654602e58p+0, 0x1.64b63ea2acb4bp+0, 0x1.7c8cf8427b26ep-4, 0x1.20821040b7d8bp-2},
+    {0x1.4bfc38c486d8ap-1, 0x1.56b192e507eeep-1, -0x1.149e836f192fdp+0, 0x1.23543dec5a0fcp-2,
+     0x1.d27bf27c6aaafp-4, 0x1.bc38efd644bd1p-1, -0x1.68a93f10b89eep-5, 0x1.fd7bf9478f663p-3},
+};
+
+constexpr double golden_beta[4][8] = {
+    {0x1.3509b72bd4c3bp-1, 0x1.98ed05b29d9a9p-1, 0x1.3f1c9f6a699e2p-2, 0x1.fe9dd5275671bp-2,
+     0x1.a93f4571741d6p-2, 0x1.4ee5f876d5d2dp-1, 0x1.11c587098e8f6p-6, 0x1.c15b9102222bfp-1},
+    {0x1.745e2d2a6190cp-1, 0x1.d50877d810793p-2, 0x1.8516c368b7da6p-1, 0x1.c981f95d000fdp-1,
+     0x1.7c8f0e3852c1dp-1, 0x1.fc5b5118bda42p-2, 0x1.bdb03dc46eec1p-4, 0x1.4b8cd96fad4b7p-1},
+    {0x1.255068518faa3p-2, 0x1.01dc003a72e8fp-1, 0x1.ce865050b99e6p-2, 0x1.4d3cebc9218cfp-4,
+     0x1.362a3448831dbp-1, 0x1.da6f348fe8ad6p-3, 0x1.c60eafb7ec8ebp-1, 0x1.76dfc79ef12eap-2},
+    {0x1.9d7417925ac73p-2, 0x1.5225a9cb76be4p-3, 0x1.5e8d63a780a90p-2, 0x1.097b89c81a81fp-2,
+     0x1.752d7a2cad599p-1, 0x1.da44fd488a813p-2, 0x1.0772be35ea5dep-1, 0x1.2af61f447d58dp-2},
+};
+
+constexpr double golden_beta_small[4][8] = {
+    {0x1.e80eed1b7a822p-3, 0x1.d4b7c11e89b40p-2, 0x1.2a12d9a27372ap-3, 0x1.3fdc598fda4c9p-4,
+     0x1.d0306fcdf14e3p-1, 0x1.62ca3bea4f964p-1, 0x1.3e84fa4468e0dp-3, 0x1.fcffa071fda35p-5},
+    {0x1.c0c0e86578f5ep-4, 0x1.96c04d507cafcp-40, 0x1.90ed66a22ed50p-2, 0x1.99292ddadddbbp-5,
+     0x1.6aea6e337c53ep-3, 0x1.fcd1ec74deff3p-4, 0x1.c57a44f492facp-8, 0x1.1a3cc27c280f3p-16},
+    {0x1.ddb2c43e712aep-1, 0x1.428dbf0cc1a8cp-3, 0x1.6cdfb5830f164p-2, 0x1.0cb877a19174bp-1,
+     0x1.102225b780680p-15, 0x1.8dc5dd524bd6ep-5, 0x1.60759f2fd25e2p-2, 0x1.228ad676e4ff6p-1},
+    {0x1.1a66df6bdbbbap-11, 0x1.d4ec0862883acp-2, 0x1.b65fc02a31dfbp-20, 0x1.e93b667bef08ap-1,
+     0x1.85e56628a5970p-1, 0x1.3fa6da34640a8p-1, 0x1.99d90f55b0a34p-1, 0x1.5ce59c6ddabe4p-8},
+};
+
+constexpr int64_t golden_binomial[4][8] = {
+    {3LL, 4LL, 3LL, 3LL, 3LL, 3LL, 3LL, 5LL},
+    {3LL, 4LL, 0LL, 2LL, 1LL, 1LL, 2LL, 2LL},
+    {5LL, 2LL, 2LL, 2LL, 3LL, 3LL, 6LL, 4LL},
+    {1LL, 5LL, 4LL, 4LL, 0LL, 6LL, 3LL, 1LL},
+};
+
+constexpr int64_t golden_binomial_btpe[4][8] = {
+    {403LL, 410LL, 399LL, 392LL, 395LL, 397LL, 401LL, 375LL},
+    {396LL, 390LL, 404LL, 398LL, 401LL, 398LL, 382LL, 380LL},
+    {429LL, 402LL, 407LL, 397LL, 393LL, 407LL, 411LL, 397LL},
+    {376LL, 370LL, 423LL, 438LL, 409LL, 378LL, 392LL, 390LL},
+};
+
+constexpr double golden_gamma[4][8] = {
+    {0x1.1d0ec115f826cp+3, 0x1.0dd304619600dp+2, 0x1.2b9f32fa136b6p+3, 0x1.88d76c1a46c89p+0,
+     0x1.838155e2ae7c8p+1, 0x1.0f9542d6d3ad5p+2, 0x1.4f23a704ea832p+2, 0x1.c357f37d8f33dp+1},
+    {0x1.0a28abb075051p+3, 0x1.09f40cb9ad8b8p+1, 0x1.1bdf3b595461bp+1, 0x1.68f30361f143fp+0,
+     0x1.1a6746ac5905bp+3, 0x1.d7a5a8b02e30ap+0, 0x1.ea90efc4703acp+2, 0x1.f942154531508p-2},
+    {0x1.68c9692cd5b55p+1, 0x1.1b48cbe01f8e1p+2, 0x1.d990aedd36b40p+2, 0x1.50b141c42135ap+2,
+     0x1.b6862ff80937ep+2, 0x1.8140fcf338328p+2, 0x1.255ac7d9ce202p+0, 0x1.cfbb712949bb4p+2},
+    {0x1.39bce27952a1cp+2, 0x1.3da41847e220fp+2, 0x1.66804652d9fe7p+0, 0x1.f5b23429eddf0p+1,
+     0x1.93ae60ef66b7ep+1, 0x1.ea579359fd503p+1, 0x1.98a6a72ee52e8p+1, 0x1.80a7990981dbdp+2},
+};
+
+constexpr double golden_gamma_small[4][8] = {
+    {0x1.374c4579c716cp-1, 0x1.8359a96ac590bp-1, 0x1.6f94fcaf8a8b3p-2, 0x1.88280327fb2fcp-2,
+     0x1.c25c0cee6d156p+0, 0x1.506064684016dp-1, 0x1.4ab3df171cacbp-7, 0x1.aca402c01cbbap-11},
+    {0x1.642989b8f26f9p-2, 0x1.c17af5d62e42bp-26, 0x1.60ddf2a5e21f7p-5, 0x1.1c3436cb0d0a5p-4,
+     0x1.4267bd23ae80fp-2, 0x1.67e201867dd33p-2, 0x1.566e77f7d1120p-4, 0x1.894211876b0d9p-10},
+    {0x1.187e3c62807f0p+2, 0x1.151a88e173120p-4, 0x1.4ff153bf3506bp-1, 0x1.a9440d6d04380p+2,
+     0x1.6d0df9141a998p+0, 0x1.6b029ed534daep+0, 0x1.2720473f80ac2p-13, 0x1.6d760c98ae569p-3},
+    {0x1.3858523bcdb1dp-6, 0x1.bc380f5c7e84dp+0, 0x1.517717f438019p-11, 0x1.74799ec1c0d0ap-1,
+     0x1.d549711b93d5ap+1, 0x1.ae838cfb83ca6p-3, 0x1.2373215e22e08p+2, 0x1.8fc11c740b1cep+1},
+};
+
+constexpr double golden_exponential[4][8] = {
+    {0x1.977cdd108fb06p+0, 0x1.4184adb0fa85ap+1, 0x1.d8b0b4444705bp+0, 0x1.930c07892702bp+0,
+     0x1.1a23071f87d79p+0, 0x1.09c4cebbd23b8p+1, 0x1.26aa73d54c809p+0, 0x1.1c9c72adea9b1p+2},
+    {0x1.1447375f848e8p+0, 0x1.462d1294b32a8p+1, 0x1.dfc00c750c880p-13, 0x1.70a72f00f637dp-1,
+     0x1.450989476153dp-2, 0x1.8cd61a4433ccfp-3, 0x1.a61f6de4e057fp-2, 0x1.b226e40e89c10p-1},
+    {0x1.53af6955cd33ep+2, 0x1.8579922450223p-1, 0x1.a03d0b6fb0dfdp-2, 0x1.d4b4a936d41bap-2,
+     0x1.ad6938347efd0p+0, 0x1.cf7837b6d1e40p+0, 0x1.ab58485c0aa1bp+2, 0x1.0f16c1cda9823p+1},
+    {0x1.a4cb3eb533395p-3, 0x1.37a6d2278b03dp+2, 0x1.8e5a3dab9e9c1p+1, 0x1.839ef26aa395ap+1,
+     0x1.28978f19fe2ffp-5, 0x1.bebfa18751bfcp+2, 0x1.cc7a9ed8fed92p+0, 0x1.4381340fa2e99p-2},
+};
+
+constexpr double golden_mixed[4][24] = {
+    {0x1.18fe1565f12a8p-1, 0x1.7bb1e9a384a31p-1, 0x1.0c00000000000p+6, 0x1.566fba0ad423dp+2,
+     0x1.6000000000000p+3, -0x1.8458fb01617fap+0, 0x1.d097bbdaca690p-5, -0x1.bb888e342a57ep-1,
+     0x1.8000000000000p+3, 0x1.2768af2ceff04p+2, 0x1.4000000000000p+3, -0x1.03023ff42b8a9p-1,
+     0x1.d9e7cd7582508p-1, 0x1.c6841552275cbp-2, 0x1.4800000000000p+6, 0x1.5912415cbd8e4p+1,
+     0x1.8000000000000p+3, 0x1.010b4a9e94e3ap+1, 0x1.70f6c368f4774p-1, 0x1.d6cec0b1a8725p-3,
+     0x1.0400000000000p+6, 0x1.4d24e79a6464fp-3, 0x1.8000000000000p+3, 0x1.4ea718b6f2966p-1},
+    {0x1.ab07d0ffa3c06p-2, -0x1.9ab665f778871p-1, 0x1.0000000000000p+4, 0x1.92218cdbeb8c3p+0,
+     0x1.2000000000000p+3, 0x1.ef19891292875p-2, 0x1.b14faa1ad4153p-1, 0x1.81eb0d0469bcap-3,
+     0x1.2000000000000p+4, 0x1.19b6543afb560p-3, 0x1.4000000000000p+3, 0x1.26fad564655b6p+0,
+     0x1.d3f2d49ab51f3p-1, -0x1.256a63f0135cap+1, 0x1.7800000000000p+6, 0x1.5bf31837b2ecfp-1,
+     0x1.8000000000000p+3, 0x1.75bf5c82f37c4p-1, 0x1.ca09e27510be3p-1, 0x1.7df215768b9e1p-2,
+     0x1.0000000000000p+3, 0x1.786ec4ec731a1p+0, 0x1.6000000000000p+3, 0x1.8e00fa2a48abcp-1},
+    {0x1.dbf6a3f8f84b7p-1, -0x1.ef887c7e3ecf0p-1, 0x1.1000000000000p+5, 0x1.70a0b7e7253d8p+0,
+     0x1.c000000000000p+3, 0x1.3f85a23ff8a71p+0, 0x1.4ea0b5c9eb155p-1, 0x1.89447f07609e4p-1,
+     0x1.4000000000000p+6, 0x1.392cfe8482786p+0, 0x1.6000000000000p+3, -0x1.93d34875ebc07p+0,
+     0x1.d0db8837d1baep-1, 0x1.34333afaf7410p+0, 0x1.6c00000000000p+6, 0x1.3cb206156eb45p+1,
+     0x1.6000000000000p+3, -0x1.0035a6bfb8f04p+1, 0x1.c23232108d612p-2, -0x1.7cc44a411dc16p-2,
+     0x1.2c00000000000p+6, 0x1.817c0441499d7p+0, 0x1.6000000000000p+3, 0x1.d8fb9529e9115p-1},
+    {0x1.8fe69a3924820p-4, 0x1.4d051339bc741p-4, 0x1.6000000000000p+3, 0x1.69e7bab588140p+1,
+     0x1.0000000000000p+3, 0x1.0ddd5c0d98cbep+0, 0x1.8dff7b54bfb33p-1, 0x1.0168efa823491p-1,
+     0x1.2000000000000p+3, 0x1.0bfd5860f5ab9p+1, 0x1.6000000000000p+3, 0x1.ae22bf2063e74p-2,
+     0x1.0044e4c7d8ac0p-5, 0x1.6ee5a63630a15p+0, 0x1.5c00000000000p+6, 0x1.074d4a2e69572p+2,
+     0x1.4000000000000p+3, 0x1.08cc70b3be94bp-5, 0x1.a2fa857db5e4cp-1, 0x1.7ae2e507e3c83p+0,
+     0x1.7800000000000p+6, 0x1.0041aff5ff889p+1, 0x1.c000000000000p+2, -0x1.28577db1ffe5cp-1},
+};
@@ -0,0 +1,91 @@
+"""
+Writes numpy_random_golden.h, the values NumPy's legacy RandomState draws for a few seeds. Rerun it
+when a case is added, with the NumPy the header says it came from:
+
+    python3 numpy_random_golden.py > numpy_random_golden.h
+
+RandomState(seed) seeds MT19937 with init_genrand(seed), the same as std::mt19937(seed), so
+numpy_random_test_golden.cpp draws the same values from RandomState<std::mt19937>.
+"""
+import numpy as np
+
+SEEDS = [0, 1, 12345, 4294967295]
+DRAWS = 8
+
+# name, C++ type, draw(RandomState) -> DRAWS values. Each case starts from a fresh RandomState.
+CASES = [
+    ("uniform", "double", lambda r: [r.uniform(-2.0, 3.0) for _ in range(DRAWS)]),
+    ("standard_uniform", "double", lambda r: r.random_sample(DRAWS)),
+    ("rand_int64", "int64_t", lambda r: [r.randint(-1000, 1001, dtype=np.int64)
+                                         for _ in range(DRAWS)]),
+    ("rand_int64_wide", "int64_t", lambda r: [r.randint(0, 2**40, dtype=np.int64)
+                                              for _ in range(DRAWS)]),
+    ("rand_int32", "int32_t", lambda r: [r.randint(-7, 8, dtype=np.int32) for _ in range(DRAWS)]),
+    ("rand_uint8", "uint8_t", lambda r: [r.randint(0, 200, dtype=np.uint8) for _ in range(DRAWS)]),
+    ("rand_n", "double", lambda r: [r.standard_normal() for _ in range(DRAWS)]),
+    ("beta", "double", lambda r: [r.beta(2.0, 3.0) for _ in range(DRAWS)]),
+    ("beta_small", "double", lambda r: [r.beta(0.3, 0.4) for _ in range(DRAWS)]),
+    ("binomial", "int64_t", lambda r: [r.binomial(10, 0.3) for _ in range(DRAWS)]),
+    ("binomial_btpe", "int64_t", lambda r: [r.binomial(1000, 0.4) for _ in range(DRAWS)]),
+    ("gamma", "double", lambda r: [r.gamma(2.5, 1.5) for _ in range(DRAWS)]),
+    ("gamma_small", "double", lambda r: [r.gamma(0.5, 2.0) for _ in range(DRAWS)]),
+    ("exponential", "double", lambda r: r.exponential(2.0, DRAWS)),
+]
+
+
+def mixed(r):
+    """One state shared by all methods, so the cached gauss and the buffered 32 bit words carry."""
+    out = []
+    for _ in range(DRAWS // 2):
+        out.append(r.uniform(0.0, 1.0))
+        out.append(r.standard_normal())
+        out.append(float(r.randint(0, 100, dtype=np.int32)))
+        out.append(r.gamma(2.5, 1.0))
+        out.append(float(r.binomial(20, 0.5)))
+        out.append(r.standard_normal())
+    return out
+
+
+def literal(ctype, value):
+    if ctype == "double":
+        return float(value).hex()
+    if ctype == "int64_t":
+        return "%dLL" % int(value)
+    return "%d" % int(value)
+
+
+def table(name, ctype, rows):
+    lines = ["constexpr %s golden_%s[%d][%d] = {" % (ctype, name, len(SEEDS), len(rows[0]))]
+    for row in rows:
+        # Wrapped to 100 columns like the rest of the tree.
+        line = "    {"
+        for i, v in enumerate(row):
+            item = literal(ctype, v) + (", " if i + 1 < len(row) else "},")
+            if len(line) + len(item.rstrip()) > 100:
+                lines.append(line.rstrip())
+                line = "     "
+            line += item
+        lines.append(line)
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    print("#pragma once")
+    print("#include <cstddef>")
+    print("#include <cstdint>")
+    print()
+    print("/* Generated by numpy_random_golden.py with NumPy %s, do not edit. */" % np.__version__)
+    print()
+    seeds = ", ".join("%du" % s for s in SEEDS)
+    print("constexpr uint32_t golden_seeds[%d] = {%s};" % (len(SEEDS), seeds))
+    print("constexpr size_t golden_draws = %d;" % DRAWS)
+    for name, ctype, draw in CASES:
+        print()
+        print(table(name, ctype, [list(draw(np.random.RandomState(s))) for s in SEEDS]))
+    print()
+    print(table("mixed", "double", [mixed(np.random.RandomState(s)) for s in SEEDS]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,51 @@
+#pragma once
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+/*
+Checks shared by the CTest executables. A failed check prints what differed and where, the test
+keeps going and main returns report(), 1 if anything failed.
+*/
+namespace numpy_random_test {
+inline int failures = 0;
+
+/* Bit-for-bit, so -0.0 vs 0.0 and NaN payloads count as differences. */
+inline bool check_bits(double expected, double actual, const char* what, size_t index) {
+    if (std::memcmp(&expected, &actual, sizeof(double)) == 0) {
+        return true;
+    }
+    std::fprintf(stderr, "FAIL %s[%zu]: expected %a (%.17g), got %a (%.17g)\n", what, index,
+                 expected, expected, actual, actual);
+    failures++;
+    return false;
+}
+
+inline bool check_equal(int64_t expected, int64_t actual, const char* what, size_t index) {
+    if (expected == actual) {
+        return true;
+    }
+    std::fprintf(stderr, "FAIL %s[%zu]: expected %" PRId64 ", got %" PRId64 "\n", what, index,
+                 expected, actual);
+    failures++;
+    return false;
+}
+
+inline bool check(bool ok, const char* what) {
+    if (!ok) {
+        std::fprintf(stderr, "FAIL %s\n", what);
+        failures++;
+    }
+    return ok;
+}
+
+inline int report(const char* name) {
+    if (failures > 0) {
+        std::fprintf(stderr, "%s: %d checks failed\n", name, failures);
+        return 1;
+    }
+    std::printf("%s: all checks passed\n", name);
+    return 0;
+}
+} // namespace numpy_random_test
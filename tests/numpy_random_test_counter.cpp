@@ -0,0 +1,68 @@
+/* First, so the header is checked to compile on its own. */
+#include "numpy_random_counter.h"
+
+#include <random>
+#include <string>
+#include "numpy_random.h"
+#include "numpy_random_test.h"
+
+/*
+Counter engines are regular values: copies, including from non-const lvalues which the seed
+sequence constructor must not capture, continue the same stream, and RandomState can be built
+from an engine lvalue.
+*/
+
+using numpy_random_test::check;
+using numpy_random_test::check_equal;
+
+namespace {
+template <typename Engine>
+void check_copies(const char* engine_name) {
+    const std::string name = engine_name;
+    Engine a(12345);
+    a.advance(3);
+
+    Engine b(a);
+    Engine c = a;
+    Engine d;
+    d = a;
+    const Engine& const_a = a;
+    Engine e(const_a);
+    for (size_t i = 0; i < 4; i++) {
+        auto expected = a();
+        check(b() == expected, (name + " copy constructed from an lvalue").c_str());
+        check(c() == expected, (name + " copy initialized").c_str());
+        check(d() == expected, (name + " copy assigned").c_str());
+        check(e() == expected, (name + " copy constructed from a const lvalue").c_str());
+    }
+
+    /* Seed sequences still take the seeding constructor. */
+    NumpySeedSequence<uint32_t> seq_a(7), seq_b(7);
+    Engine from_seq(seq_a);
+    Engine reseeded;
+    reseeded.seed(seq_b);
+    check(from_seq() == reseeded(), (name + " seed sequence").c_str());
+
+    /* RandomState from an engine lvalue, and get_engine copied out of it. */
+    Engine engine(99);
+    RandomState<Engine> random(engine);
+    Engine copied = random.get_engine();
+    RandomState<Engine> twin(copied);
+    for (size_t i = 0; i < 16; i++) {
+        uint64_t expected = 0, actual = 0;
+        random.uint64_fill(&expected, 1);
+        twin.uint64_fill(&actual, 1);
+        check_equal((int64_t)expected, (int64_t)actual,
+                    (name + " RandomState from an engine lvalue").c_str(), i);
+    }
+    check(engine.counter() == typename Engine::counter_type{},
+          (name + " RandomState copied the engine, the lvalue is untouched").c_str());
+}
+} // namespace
+
+int main() {
+    check_copies<Philox4x64>("Philox4x64");
+    check_copies<Threefry4x64>("Threefry4x64");
+
+    return numpy_random_test::report("numpy_random_test_counter");
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <random>
+#include "numpy_random.h"
+
+/*
+Engines for the RandomState adapter paths the standard engines don't reach: a container of 32 bit
+words and the two 128 bit word types.
+*/
+namespace numpy_random_test {
+inline uint64_t mix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/* Four mt19937 outputs per call, goes through the container path. */
+class mt19937_quad {
+public:
+    std::array<uint32_t, 4> operator()() {
+        return {(uint32_t)_engine(), (uint32_t)_engine(), (uint32_t)_engine(),
+                (uint32_t)_engine()};
+    }
+
+    void seed(uint64_t seed) {
+        _engine.seed((uint32_t)seed);
+    }
+
+private:
+    std::mt19937 _engine;
+};
+
+/* 128 bit LCG with both halves scrambled, the raw low bits have short periods. */
+class lcg128_state {
+public:
+    void seed(uint64_t seed) {
+        _hi = seed;
+        _lo = ~seed;
+    }
+
+protected:
+    /* state = state * 0x2360ed051fc65da44385df649fccf645 + 0x5851f42d4c957f2d14057b7ef767814f,
+    returns the scrambled low and high output words. */
+    std::array<uint64_t, 2> step() {
+        const uint64_t mul_hi = 0x2360ed051fc65da4ULL, mul_lo = 0x4385df649fccf645ULL;
+        const uint64_t inc_hi = 0x5851f42d4c957f2dULL, inc_lo = 0x14057b7ef767814fULL;
+        uint64_t hi = 0;
+        uint64_t lo = numpy_random_internel::mulhilo64(_lo, mul_lo, &hi);
+        hi += _lo * mul_hi + _hi * mul_lo;
+        lo += inc_lo;
+        hi += inc_hi + (lo < inc_lo);
+        _hi = hi;
+        _lo = lo;
+        return {mix64(hi ^ lo), mix64(hi)};
+    }
+
+private:
+    uint64_t _hi = 0x853c49e6748fea9bULL;
+    uint64_t _lo = 0xda3e39cb94b95bdbULL;
+};
+
+/* std::array<uint64_t, 2> outputs, RandomState's wide word path. */
+class lcg128_pair : public lcg128_state {
+public:
+    std::array<uint64_t, 2> operator()() {
+        return step();
+    }
+};
+
+#ifdef __SIZEOF_INT128__
+/* unsigned __int128 outputs, the same words as lcg128_pair. */
+class lcg128 : public lcg128_state {
+public:
+    unsigned __int128 operator()() {
+        std::array<uint64_t, 2> words = step();
+        return (unsigned __int128)words[1] << 64 | words[0];
+    }
+};
+#endif
+} // namespace numpy_random_test
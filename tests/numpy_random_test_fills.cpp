@@ -0,0 +1,182 @@
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+#include "numpy_random.h"
+#include "numpy_random_counter.h"
+#include "numpy_random_gamma.h"
+#include "numpy_random_test.h"
+#include "numpy_random_test_engines.h"
+
+extern "C" {
+#include "numpy/random/bitgen.h"
+#include "numpy/random/distributions.h"
+#include "numpy/random/legacy/legacy-distributions.h"
+}
+
+/*
+Every bulk fill against cnt draws of its scalar counterpart on a copy of the same state, for each
+kind of engine RandomState adapts. The fills take different code paths from the scalar draws
+(direct engine calls, the target_clones kernels, batched accept tests) and promise the same bits.
+*/
+
+using numpy_random_test::check;
+using numpy_random_test::check_bits;
+using numpy_random_test::check_equal;
+
+namespace {
+/* Crosses the 256 value chunks of fill_doubles and the 64 draw Bernoulli blocks unevenly. */
+constexpr size_t kCount = 1000;
+
+/* **fill** on one state, **scalar** kCount times on a clone, then one more scalar draw on each to
+check both consumed the same number of words. */
+template <typename Engine, typename Fill, typename Scalar>
+void check_fill(const std::string& name, RandomState<Engine>& random, Fill fill, Scalar scalar) {
+    RandomState<Engine> twin = random.clone();
+    std::vector<double> out(kCount);
+    fill(random, out.data(), out.size());
+    for (size_t i = 0; i < kCount; i++) {
+        if (!check_bits(scalar(twin), out[i], name.c_str(), i)) {
+            return;
+        }
+    }
+    check_bits(scalar(twin), scalar(random), (name + " after").c_str(), kCount);
+}
+
+/* A C scalar kernel run through with_bitgen. */
+template <typename Engine, typename Kernel>
+double with_kernel(RandomState<Engine>& random, Kernel kernel) {
+    double value = 0.0;
+    random.with_bitgen([&](bitgen_t* bitgen_state, aug_bitgen_t* aug_state, binomial_t*) {
+        value = kernel(bitgen_state, aug_state);
+    });
+    return value;
+}
+
+template <typename Engine>
+void check_engine(const char* engine_name) {
+    using State = RandomState<Engine>;
+    const std::string prefix = std::string(engine_name) + " ";
+    State random;
+    random.get_engine().seed(12345);
+
+    check_fill(prefix + "standard_uniform_fill", random,
+               [](State& r, double* out, size_t cnt) { r.standard_uniform_fill(out, cnt); },
+               [](State& r) { return r.uniform(0.0, 1.0); });
+    check_fill(
+        prefix + "random_standard_uniform_fill", random,
+        [](State& r, double* out, size_t cnt) {
+            r.with_bitgen([&](bitgen_t* bitgen_state, aug_bitgen_t*, binomial_t*) {
+                random_standard_uniform_fill(bitgen_state, (npy_intp)cnt, out);
+            });
+        },
+        [](State& r) {
+            return with_kernel(
+                r, [](bitgen_t* b, aug_bitgen_t*) { return random_standard_uniform(b); });
+        });
+    check_fill(prefix + "standard_normal_fill", random,
+               [](State& r, double* out, size_t cnt) { r.standard_normal_fill(out, cnt); },
+               [](State& r) {
+                   return with_kernel(
+                       r, [](bitgen_t* b, aug_bitgen_t*) { return random_standard_normal(b); });
+               });
+    check_fill(prefix + "standard_exponential_fill", random,
+               [](State& r, double* out, size_t cnt) { r.standard_exponential_fill(out, cnt); },
+               [](State& r) {
+                   return with_kernel(r, [](bitgen_t* b, aug_bitgen_t*) {
+                       return random_standard_exponential(b);
+                   });
+               });
+    check_fill(prefix + "exponential_fill", random,
+               [](State& r, double* out, size_t cnt) { r.exponential_fill(2.0, out, cnt); },
+               [](State& r) {
+                   return with_kernel(r, [](bitgen_t*, aug_bitgen_t* a) {
+                       return legacy_exponential(a, 2.0);
+                   });
+               });
+
+    /* GammaSampler fills against its own single draws, and the legacy stream against
+    RandomState::gamma. Shapes below, at and above 1 take different branches. */
+    for (double shape : {0.5, 1.0, 3.0}) {
+        const std::string gamma = prefix + "GammaSampler(" + std::to_string(shape) + ") ";
+        GammaSampler legacy(shape, 1.5, GammaSampler::stream::legacy);
+        GammaSampler ziggurat(shape, 1.5, GammaSampler::stream::ziggurat);
+        check_fill(gamma + "legacy fill", random,
+                   [&](State& r, double* out, size_t cnt) { legacy.fill(r, out, cnt); },
+                   [&](State& r) { return legacy(r); });
+        check_fill(gamma + "legacy gamma", random,
+                   [&](State& r, double* out, size_t cnt) { legacy.fill(r, out, cnt); },
+                   [&](State& r) { return r.gamma(shape, 1.5); });
+        check_fill(gamma + "ziggurat fill", random,
+                   [&](State& r, double* out, size_t cnt) { ziggurat.fill(r, out, cnt); },
+                   [&](State& r) { return ziggurat(r); });
+    }
+
+    /* uint64_fill against the bitgen's own next_uint64. */
+    {
+        State twin = random.clone();
+        std::vector<uint64_t> words(kCount);
+        random.uint64_fill(words.data(), words.size());
+        twin.with_bitgen([&](bitgen_t* bitgen_state, aug_bitgen_t*, binomial_t*) {
+            for (size_t i = 0; i < kCount; i++) {
+                uint64_t expected = bitgen_state->next_uint64(bitgen_state->state);
+                if (!check_equal((int64_t)expected, (int64_t)words[i],
+                                 (prefix + "uint64_fill").c_str(), i)) {
+                    break;
+                }
+            }
+        });
+    }
+
+    /* The byte and packed Bernoulli fills consume identical streams. */
+    {
+        State twin = random.clone();
+        std::vector<uint8_t> bytes(kCount);
+        std::vector<uint64_t> packed((kCount + 63) / 64);
+        random.bernoulli_fill(0.3, bytes.data(), bytes.size());
+        twin.bernoulli_fill_packed(0.3, packed.data(), kCount);
+        for (size_t i = 0; i < kCount; i++) {
+            if (!check_equal(bytes[i], (int64_t)((packed[i / 64] >> (i % 64)) & 1),
+                             (prefix + "bernoulli_fill_packed").c_str(), i)) {
+                break;
+            }
+        }
+        check(packed.back() >> (kCount % 64) == 0,
+              (prefix + "bernoulli_fill_packed clears the unused bits").c_str());
+    }
+}
+
+/* 128 bit engines are split low word first, check uint64_fill against the raw engine output. */
+template <typename Engine>
+void check_wide_words(const char* engine_name) {
+    using wide = numpy_random_internel::wide_word<decltype(std::declval<Engine>()())>;
+    RandomState<Engine> random;
+    random.get_engine().seed(12345);
+    Engine engine = random.get_engine();
+    std::vector<uint64_t> words(kCount);
+    random.uint64_fill(words.data(), words.size());
+    const std::string what = std::string(engine_name) + " wide words";
+    for (size_t i = 0; i < kCount; i += 2) {
+        auto value = engine();
+        if (!check_equal((int64_t)wide::lo(value), (int64_t)words[i], what.c_str(), i) ||
+            !check_equal((int64_t)wide::hi(value), (int64_t)words[i + 1], what.c_str(), i + 1)) {
+            break;
+        }
+    }
+}
+} // namespace
+
+int main() {
+    check_engine<std::mt19937>("mt19937");
+    check_engine<std::mt19937_64>("mt19937_64");
+    check_engine<Philox4x64>("Philox4x64");
+    check_engine<numpy_random_test::mt19937_quad>("mt19937_quad");
+#ifdef __SIZEOF_INT128__
+    check_engine<numpy_random_test::lcg128>("lcg128");
+    check_wide_words<numpy_random_test::lcg128>("lcg128");
+#endif
+    check_engine<numpy_random_test::lcg128_pair>("lcg128_pair");
+    check_wide_words<numpy_random_test::lcg128_pair>("lcg128_pair");
+
+    return numpy_random_test::report("numpy_random_test_fills");
+}
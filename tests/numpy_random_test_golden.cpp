@@ -0,0 +1,106 @@
+#include <random>
+#include <string>
+#include "numpy_random.h"
+#include "numpy_random_golden.h"
+#include "numpy_random_test.h"
+
+/*
+RandomState<std::mt19937> against the values NumPy's RandomState draws for the same seeds, see
+numpy_random_golden.py. Any change to a legacy stream shows up here.
+*/
+
+using numpy_random_test::check_bits;
+using numpy_random_test::check_equal;
+
+namespace {
+using State = RandomState<std::mt19937>;
+
+/* Runs **draw(state, i)** golden_draws times on a fresh state per seed, compares against
+**expected** with **compare**. */
+template <typename T, typename Draw, typename Compare>
+void check_case(const char* name, const T (&expected)[4][golden_draws], Draw draw,
+                Compare compare) {
+    for (size_t s = 0; s < 4; s++) {
+        State state(golden_seeds[s]);
+        std::string what = std::string(name) + " seed " + std::to_string(golden_seeds[s]);
+        for (size_t i = 0; i < golden_draws; i++) {
+            compare(expected[s][i], draw(state), what.c_str(), i);
+        }
+    }
+}
+
+template <typename Draw>
+void check_doubles(const char* name, const double (&expected)[4][golden_draws], Draw draw) {
+    check_case(name, expected, draw, check_bits);
+}
+
+template <typename T, typename Draw>
+void check_integers(const char* name, const T (&expected)[4][golden_draws], Draw draw) {
+    check_case(name, expected, draw,
+               [](T e, T a, const char* what, size_t i) { check_equal(e, a, what, i); });
+}
+
+/* The bulk fills have to agree with NumPy too, not only with the scalar methods. */
+template <typename Fill>
+void check_fill(const char* name, const double (&expected)[4][golden_draws], Fill fill) {
+    for (size_t s = 0; s < 4; s++) {
+        State state(golden_seeds[s]);
+        double out[golden_draws];
+        fill(state, out, golden_draws);
+        std::string what = std::string(name) + " seed " + std::to_string(golden_seeds[s]);
+        for (size_t i = 0; i < golden_draws; i++) {
+            check_bits(expected[s][i], out[i], what.c_str(), i);
+        }
+    }
+}
+} // namespace
+
+int main() {
+    check_doubles("uniform", golden_uniform, [](State& r) { return r.uniform(-2.0, 3.0); });
+    check_doubles("standard_uniform", golden_standard_uniform,
+                  [](State& r) { return r.uniform(0.0, 1.0); });
+    check_fill("standard_uniform_fill", golden_standard_uniform,
+               [](State& r, double* out, size_t cnt) { r.standard_uniform_fill(out, cnt); });
+
+    /* rand_int takes an inclusive high, numpy's randint an exclusive one. */
+    check_integers("rand_int64", golden_rand_int64,
+                   [](State& r) { return r.rand_int<int64_t>(-1000, 1000); });
+    check_integers("rand_int64_wide", golden_rand_int64_wide,
+                   [](State& r) { return r.rand_int<int64_t>(0, ((int64_t)1 << 40) - 1); });
+    check_integers("rand_int32", golden_rand_int32,
+                   [](State& r) { return r.rand_int<int32_t>(-7, 7); });
+    check_integers("rand_uint8", golden_rand_uint8,
+                   [](State& r) { return r.rand_int<uint8_t>(0, 199); });
+
+    check_doubles("rand_n", golden_rand_n, [](State& r) { return r.rand_n<double>(); });
+    check_doubles("beta", golden_beta, [](State& r) { return r.beta(2.0, 3.0); });
+    check_doubles("beta_small", golden_beta_small, [](State& r) { return r.beta(0.3, 0.4); });
+    check_integers("binomial", golden_binomial, [](State& r) { return r.binomial(10, 0.3); });
+    check_integers("binomial_btpe", golden_binomial_btpe,
+                   [](State& r) { return r.binomial(1000, 0.4); });
+    check_doubles("gamma", golden_gamma, [](State& r) { return r.gamma(2.5, 1.5); });
+    check_doubles("gamma_small", golden_gamma_small, [](State& r) { return r.gamma(0.5, 2.0); });
+    check_fill("exponential_fill", golden_exponential,
+               [](State& r, double* out, size_t cnt) { r.exponential_fill(2.0, out, cnt); });
+
+    /* One state through every method, the order numpy_random_golden.py's mixed() uses. */
+    for (size_t s = 0; s < 4; s++) {
+        State r(golden_seeds[s]);
+        std::string what = "mixed seed " + std::to_string(golden_seeds[s]);
+        size_t i = 0;
+        for (size_t k = 0; k < golden_draws / 2; k++) {
+            const double row[6] = {r.uniform(0.0, 1.0),
+                                   r.rand_n<double>(),
+                                   (double)r.rand_int<int32_t>(0, 99),
+                                   r.gamma(2.5, 1.0),
+                                   (double)r.binomial(20, 0.5),
+                                   r.rand_n<double>()};
+            for (double value : row) {
+                check_bits(golden_mixed[s][i], value, what.c_str(), i);
+                i++;
+            }
+        }
+    }
+
+    return numpy_random_test::report("numpy_random_test_golden");
+}
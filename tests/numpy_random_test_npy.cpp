@@ -0,0 +1,75 @@
+/* First, so the header is checked to compile on its own. */
+#include "numpy_random_npy.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "numpy_random.h"
+#include "numpy_random_test.h"
+
+/*
+NpyArray is a range, so the range overloads of the fills take it and write straight into the image.
+The values must be the bits a plain pointer fill gives on a copy of the same state.
+*/
+
+using numpy_random_test::check;
+using numpy_random_test::check_bits;
+
+namespace {
+using State = RandomState<std::mt19937_64>;
+
+void check_filled(const std::string& name, const NpyArray<double>& array,
+                  const std::vector<double>& expected) {
+    if (!check(array.is_open() && array.size() == expected.size(), (name + " open").c_str())) {
+        return;
+    }
+    size_t i = 0;
+    for (double value : array) {
+        if (!check_bits(expected[i], value, name.c_str(), i)) {
+            return;
+        }
+        i++;
+    }
+    check(std::memcmp(array.bytes(), "\x93NUMPY", 6) == 0, (name + " header").c_str());
+}
+
+void check_range_fill(const std::string& name, NpyArray<double>& array) {
+    State random;
+    random.get_engine().seed(31415);
+    State twin = random.clone();
+
+    random.standard_normal_fill(array);
+    std::vector<double> expected(array.size());
+    twin.standard_normal_fill(expected.data(), expected.size());
+    check_filled(name + " standard_normal_fill", array, expected);
+
+    random.standard_uniform_fill(array);
+    twin.standard_uniform_fill(expected.data(), expected.size());
+    check_filled(name + " standard_uniform_fill", array, expected);
+}
+} // namespace
+
+int main() {
+    /* Not a multiple of the 256 value blocks of the buffered range path. */
+    NpyArray<double> in_memory({7, 131});
+    check_range_fill("in memory", in_memory);
+
+    const char* path = "numpy_random_test_npy.npy";
+    {
+        NpyArray<double> mapped(path, {1000});
+        check_range_fill("file backed", mapped);
+        check(mapped.flush(), "file backed flush");
+    }
+    std::remove(path);
+
+    /* A failed open is an empty range, the fill writes nothing. */
+    NpyArray<double> failed("no_such_directory/numpy_random_test_npy.npy", {16});
+    check(!failed.is_open() && failed.size() == 0 && failed.begin() == failed.end(),
+          "failed open is empty");
+    State random;
+    random.standard_normal_fill(failed);
+
+    return numpy_random_test::report("numpy_random_test_npy");
+}
@@ -0,0 +1,48 @@
+#include <random>
+#include <string>
+#include <vector>
+#include "numpy_random.h"
+#include "numpy_random_pool.h"
+#include "numpy_random_test.h"
+
+/*
+RandomStatePool::rand_int takes every integral type like RandomState::rand_int, including long long
+on LP64 where it is not int64_t. Each type draws the same values as the fixed width type of its
+size on an identically seeded pool.
+*/
+
+using numpy_random_test::check_equal;
+
+namespace {
+constexpr size_t kAgents = 64;
+
+template <typename T, typename Fixed>
+void check_same_draws(const char* name, T low, T high) {
+    NumpySeedSequence<uint32_t> seq_a(2024), seq_b(2024);
+    RandomStatePool<std::mt19937_64> pool_a(seq_a, kAgents), pool_b(seq_b, kAgents);
+    std::vector<T> values(kAgents);
+    std::vector<Fixed> expected(kAgents);
+    for (size_t round = 0; round < 4; round++) {
+        pool_a.rand_int(low, high, values.data());
+        pool_b.rand_int((Fixed)low, (Fixed)high, expected.data());
+        for (size_t i = 0; i < kAgents; i++) {
+            if (!check_equal((int64_t)expected[i], (int64_t)values[i], name, i) ||
+                !numpy_random_test::check(low <= values[i] && values[i] <= high, name)) {
+                return;
+            }
+        }
+    }
+}
+} // namespace
+
+int main() {
+    check_same_draws<long long, int64_t>("rand_int<long long>", -1000, 1000);
+    check_same_draws<unsigned long long, uint64_t>("rand_int<unsigned long long>", 5, 1ULL << 40);
+    check_same_draws<long, int64_t>("rand_int<long>", -7, 7);
+    check_same_draws<int, int32_t>("rand_int<int>", -100, 100);
+    check_same_draws<short, int16_t>("rand_int<short>", -300, 300);
+    check_same_draws<char, int8_t>("rand_int<char>", 0, 100);
+    check_same_draws<unsigned char, uint8_t>("rand_int<unsigned char>", 10, 250);
+
+    return numpy_random_test::report("numpy_random_test_pool");
+}
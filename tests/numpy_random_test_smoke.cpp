@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "numpy_random.h"
+#include "numpy_random_counter.h"
+#include "numpy_random_test.h"
+#include "numpy_random_test_engines.h"
+
+/*
+Statistical smoke tests of the bulk fills on every word path of RandomState. Not a TestU01 run, it
+catches the gross failures a broken word split produces: dropped or repeated halves, zeroed bits,
+words out of order. The seeds are fixed so a pass is reproducible, the bounds are loose enough (|z|
+< 6, KS at alpha = 0.001) that a correct engine passes with any seed.
+*/
+
+using numpy_random_test::check;
+
+namespace {
+constexpr size_t kDraws = 1 << 19;
+constexpr size_t kBins = 256;
+
+/* z score of Pearson's chi-square over **counts** against equal expectation. */
+double chi_square_z(const std::vector<size_t>& counts, size_t total) {
+    double expected = (double)total / (double)counts.size();
+    double chi2 = 0.0;
+    for (size_t c : counts) {
+        double d = (double)c - expected;
+        chi2 += d * d / expected;
+    }
+    double df = (double)(counts.size() - 1);
+    return (chi2 - df) / std::sqrt(2.0 * df);
+}
+
+/* sqrt(n) * D_n of **values** against **cdf**, sorts **values**. */
+template <typename Cdf>
+double ks_statistic(std::vector<double>& values, Cdf cdf) {
+    std::sort(values.begin(), values.end());
+    double n = (double)values.size();
+    double d = 0.0;
+    for (size_t i = 0; i < values.size(); i++) {
+        double f = cdf(values[i]);
+        d = std::max(d, std::max((double)(i + 1) / n - f, f - (double)i / n));
+    }
+    return std::sqrt(n) * d;
+}
+
+/* Asymptotic critical value of sqrt(n) * D_n at alpha = 0.001. */
+constexpr double kKsCritical = 1.95;
+constexpr double kZLimit = 6.0;
+
+bool check_z(const std::string& name, const char* test, double z) {
+    std::printf("%-48s %-16s z = %+.3f\n", name.c_str(), test, z);
+    return check(std::fabs(z) < kZLimit, (name + " " + test).c_str());
+}
+
+bool check_ks(const std::string& name, double ks) {
+    std::printf("%-48s %-16s sqrt(n)D = %.3f\n", name.c_str(), "ks", ks);
+    return check(ks < kKsCritical, (name + " ks").c_str());
+}
+
+template <typename Engine>
+void check_uniform(const std::string& name, RandomState<Engine>& random) {
+    std::vector<double> values(kDraws);
+    random.standard_uniform_fill(values.data(), values.size());
+
+    std::vector<size_t> counts(kBins);
+    for (double v : values) {
+        counts[std::min((size_t)(v * kBins), kBins - 1)]++;
+    }
+    check_z(name, "chi2 bins", chi_square_z(counts, kDraws));
+
+    /* Consecutive pairs on a 16x16 grid, a repeated or shifted word shows up on the diagonal. */
+    std::vector<size_t> pairs(16 * 16);
+    for (size_t i = 0; i + 1 < kDraws; i += 2) {
+        pairs[(size_t)(values[i] * 16) * 16 + (size_t)(values[i + 1] * 16)]++;
+    }
+    check_z(name, "chi2 pairs", chi_square_z(pairs, kDraws / 2));
+
+    check_ks(name, ks_statistic(values, [](double x) { return x; }));
+
+    /* Sorted now. 2^19 draws of 53 bits repeat with probability 2^-16, of 32 bits ~32 times, so
+    this catches a double built from one word where it takes two. */
+    size_t repeats = 0;
+    for (size_t i = 1; i < kDraws; i++) {
+        repeats += values[i] == values[i - 1];
+    }
+    std::printf("%-48s %-16s %zu\n", name.c_str(), "repeats", repeats);
+    check(repeats <= 2, (name + " repeats").c_str());
+}
+
+template <typename Engine>
+void check_normal(const std::string& name, RandomState<Engine>& random) {
+    std::vector<double> values(kDraws);
+    random.standard_normal_fill(values.data(), values.size());
+
+    double sum = 0.0, sum_sq = 0.0;
+    for (double v : values) {
+        sum += v;
+        sum_sq += v * v;
+    }
+    double n = (double)kDraws;
+    check_z(name, "mean", sum / std::sqrt(n));
+    /* Var of x^2 is 2 for a standard normal. */
+    check_z(name, "variance", (sum_sq - n) / std::sqrt(2.0 * n));
+
+    check_ks(name,
+             ks_statistic(values, [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); }));
+}
+
+/* Each bit position of the raw words is set half the time, a zeroed or repeated half is not. */
+template <typename Engine>
+void check_bits(const std::string& name, RandomState<Engine>& random) {
+    constexpr size_t n_words = kDraws / 4;
+    std::vector<uint64_t> words(n_words);
+    random.uint64_fill(words.data(), words.size());
+    double worst = 0.0;
+    for (unsigned bit = 0; bit < 64; bit++) {
+        size_t ones = 0;
+        for (uint64_t w : words) {
+            ones += (size_t)((w >> bit) & 1);
+        }
+        double z = ((double)ones - n_words / 2.0) / std::sqrt(n_words / 4.0);
+        if (std::fabs(z) > std::fabs(worst)) {
+            worst = z;
+        }
+    }
+    check_z(name, "worst bit", worst);
+}
+
+template <typename Engine>
+void check_engine(const char* engine_name) {
+    RandomState<Engine> random;
+    random.get_engine().seed(20240601);
+    check_uniform(std::string(engine_name) + " standard_uniform_fill", random);
+    check_normal(std::string(engine_name) + " standard_normal_fill", random);
+    check_bits(std::string(engine_name) + " uint64_fill", random);
+}
+} // namespace
+
+int main() {
+    check_engine<std::mt19937>("mt19937");
+    check_engine<std::mt19937_64>("mt19937_64");
+    check_engine<Philox4x64>("Philox4x64");
+    check_engine<numpy_random_test::mt19937_quad>("mt19937_quad");
+#ifdef __SIZEOF_INT128__
+    check_engine<numpy_random_test::lcg128>("lcg128");
+#endif
+    check_engine<numpy_random_test::lcg128_pair>("lcg128_pair");
+
+    return numpy_random_test::report("numpy_random_test_smoke");
+}